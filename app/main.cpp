@@ -4,9 +4,22 @@
 
 int main(int argc, const char* argv[])
 {
-    // Create the app
-    JohnchessApp johnchess_app = JohnchessApp(argc, argv);
-    johnchess_app.main_loop();
+    try
+    {
+        // Create the app
+        JohnchessApp johnchess_app = JohnchessApp(argc, argv);
+        johnchess_app.main_loop();
+    }
+    catch (const JohnchessApp::ArgumentError& e)
+    {
+        std::cerr << "johnchess: " << e.what() << "\n" << JohnchessApp::usage();
+        return 2;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "johnchess: " << e.what() << std::endl;
+        return 1;
+    }
 }
 
 #else
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "move.h"
+
+// Simplified ABDADA: threads record the moves they are currently searching, so another thread
+// reaching the same node can defer those moves and search its other moves first.
+// Entries are plain hashes of (position, move), so races between threads only cost a little
+// duplicated or deferred work, never correctness.
+class AbdadaTable
+{
+private:
+    static constexpr size_t BUCKETS = 1 << 15;
+    static constexpr size_t WAYS = 4;
+
+    std::unique_ptr<std::array<std::atomic<uint64_t>, BUCKETS * WAYS>> m_entries;
+
+    static size_t bucket(uint64_t move_key) { return (move_key & (BUCKETS - 1)) * WAYS; }
+
+public:
+    AbdadaTable() : m_entries(std::make_unique<std::array<std::atomic<uint64_t>, BUCKETS * WAYS>>())
+    {
+        clear();
+    }
+
+    static uint64_t move_key(uint64_t position_hash, const Move& move)
+    {
+        uint64_t m = move.get_from_loc().get_raw() | (move.get_to_loc().get_raw() << 6);
+        if (move.get_promotion_type())
+            m |= (static_cast<uint64_t>(*move.get_promotion_type()) + 1) << 12;
+        return position_hash ^ (m * 0x9E3779B97F4A7C15ULL);
+    }
+
+    //! Return whether another thread is searching this move
+    bool is_searching(uint64_t move_key) const
+    {
+        for (size_t i = bucket(move_key), end = i + WAYS; i < end; ++i)
+        {
+            if ((*m_entries)[i].load(std::memory_order_relaxed) == move_key)
+                return true;
+        }
+        return false;
+    }
+
+    void start_search(uint64_t move_key)
+    {
+        for (size_t i = bucket(move_key), end = i + WAYS; i < end; ++i)
+        {
+            auto& entry = (*m_entries)[i];
+            if (entry.load(std::memory_order_relaxed) == 0)
+            {
+                entry.store(move_key, std::memory_order_relaxed);
+                return;
+            }
+        }
+        // Bucket full: the move just won't be deferred by others.
+    }
+
+    void finish_search(uint64_t move_key)
+    {
+        for (size_t i = bucket(move_key), end = i + WAYS; i < end; ++i)
+        {
+            auto& entry = (*m_entries)[i];
+            if (entry.load(std::memory_order_relaxed) == move_key)
+            {
+                entry.store(0, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (auto& entry : *m_entries)
+            entry.store(0, std::memory_order_relaxed);
+    }
+};
@@ -4,8 +4,10 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <optional>
 
 #include "search_tree.h"
+#include "search_thread_pool.h"
 #include "bitboards/bitboard.h"
 
 class AI
@@ -14,11 +16,74 @@ public:
     AI(PieceColour colour) : m_colour(colour) {}
     virtual ~AI() {}
 
-    virtual Move make_move(BitBoard& board, std::chrono::steady_clock::time_point deadline,
+    virtual Move make_move(BitBoard& board, const SearchLimits& limits,
                            ThinkCallback think_cb = nullptr) = 0;
 
+    Move make_move(BitBoard& board, std::chrono::steady_clock::time_point deadline,
+                   ThinkCallback think_cb = nullptr)
+    {
+        return make_move(board, SearchLimits::until(deadline), think_cb);
+    }
+
     void set_colour(PieceColour colour) { m_colour = colour; }
 
+    //! Start searching in the background; collect the move with finish_move()
+    /*!
+     * \param ponder if true, the search ignores its limits until ponder_hit()
+     */
+    virtual void start_move(const BitBoard& board, const SearchLimits& limits,
+                            ThinkCallback think_cb = nullptr, bool ponder = false) = 0;
+
+    //! Set the positions of the game so far, ending with the one the next search starts from
+    virtual void set_history(const PositionHistory& history) = 0;
+
+    //! Whether a search (normal or ponder) is still running
+    virtual bool is_thinking() = 0;
+
+    //! Ask the running search to finish as soon as possible
+    virtual void stop() = 0;
+
+    //! Wait for the running search to finish and return its move
+    virtual Move finish_move() = 0;
+
+    //! Start searching the position after the opponent's expected reply, until told otherwise
+    /*!
+     * \param board position after our own move, with the opponent to move
+     * \return the expected reply being pondered on, or nothing if there is no good guess
+     */
+    virtual std::optional<Move> start_pondering(const BitBoard& board, ThinkCallback think_cb = nullptr) = 0;
+
+    //! The opponent played the expected reply: the ponder search continues within the given
+    //! limits, and its move is collected with finish_move()
+    virtual void ponder_hit(const SearchLimits& limits) = 0;
+
+    //! The opponent played something else, or pondering is no longer wanted: abandon the search
+    virtual void stop_pondering() = 0;
+
+    //! Best move stored in the transposition table for this position, if any
+    virtual std::optional<Move> hash_move(const BitBoard& board) const = 0;
+
+    //! Forget everything learned in previous searches
+    virtual void clear_hash() = 0;
+
+    //! Set the number of threads used by subsequent searches
+    virtual void set_threads(unsigned n_threads) = 0;
+
+    //! Choose the parallel search algorithm used by subsequent searches
+    virtual void set_parallel_mode(ParallelMode mode) = 0;
+
+    //! Change the selective pruning settings used by subsequent searches
+    virtual void set_pruning(const PruningParams& params) = 0;
+
+    //! Resize the transposition table, discarding its contents
+    virtual void set_hash_size(size_t size_mb) = 0;
+
+    //! Evaluate with a neural network in subsequent searches, or with ShannonHeuristic if nullptr
+    virtual void set_network(std::shared_ptr<const nnue::Network> network) = 0;
+
+    //! Permille of the transposition table in use
+    virtual int hashfull() const = 0;
+
 protected:
     PieceColour m_colour;
 };
@@ -26,17 +91,117 @@ protected:
 class BasicAI : public AI
 {
 private:
-    std::unique_ptr<SearchTree> m_board_tree;
+    std::unique_ptr<SearchThreadPool> m_thread_pool;
+    PositionHistory m_history;
 
 public:
-    BasicAI(PieceColour colour) : AI(colour) {}
+    BasicAI(PieceColour colour, unsigned n_threads = std::thread::hardware_concurrency()) :
+        AI(colour),
+        m_thread_pool(std::make_unique<SearchThreadPool>(n_threads))
+    {}
 
-    Move make_move(BitBoard& board, std::chrono::steady_clock::time_point deadline,
+    void set_threads(unsigned n_threads) override
+    {
+        m_thread_pool->resize(n_threads);
+    }
+
+    void set_parallel_mode(ParallelMode mode) override
+    {
+        m_thread_pool->set_mode(mode);
+    }
+
+    std::optional<Move> hash_move(const BitBoard& board) const override
+    {
+        return m_thread_pool->hash_move(board);
+    }
+
+    void clear_hash() override
+    {
+        m_thread_pool->clear_hash();
+    }
+
+    void set_pruning(const PruningParams& params) override
+    {
+        m_thread_pool->set_pruning(params);
+    }
+
+    void set_hash_size(size_t size_mb) override
+    {
+        m_thread_pool->set_hash_size(size_mb);
+    }
+
+    void set_network(std::shared_ptr<const nnue::Network> network) override
+    {
+        m_thread_pool->set_network(std::move(network));
+    }
+
+    int hashfull() const override
+    {
+        return m_thread_pool->hashfull();
+    }
+
+    void set_history(const PositionHistory& history) override
+    {
+        m_history = history;
+    }
+
+    using AI::make_move;
+
+    Move make_move(BitBoard& board, const SearchLimits& limits,
                    ThinkCallback think_cb = nullptr) override
     {
-        if (!m_board_tree)
-            m_board_tree = std::make_unique<SearchTree>(board);
+        m_thread_pool->set_history(m_history);
+        m_thread_pool->start_search(board, limits, m_colour, think_cb);
+        return m_thread_pool->wait_for_result();
+    }
 
-        return m_board_tree->search(deadline, m_colour, think_cb);
+    void start_move(const BitBoard& board, const SearchLimits& limits,
+                    ThinkCallback think_cb = nullptr, bool ponder = false) override
+    {
+        m_thread_pool->set_history(m_history);
+        m_thread_pool->start_search(board, limits, m_colour, think_cb, ponder);
+    }
+
+    bool is_thinking() override
+    {
+        return m_thread_pool->is_searching();
+    }
+
+    void stop() override
+    {
+        m_thread_pool->stop();
+    }
+
+    Move finish_move() override
+    {
+        return m_thread_pool->wait_for_result();
+    }
+
+    std::optional<Move> start_pondering(const BitBoard& board, ThinkCallback think_cb = nullptr) override
+    {
+        auto reply = hash_move(board);
+        if (!reply)
+            return std::nullopt;
+
+        BitBoard ponder_board(board);
+        PositionHistory ponder_history(m_history);
+        bool resets_clock = PositionHistory::resets_clock(ponder_board, *reply);
+        ponder_board.make_move(*reply);
+        ponder_history.push(m_thread_pool->get_hasher().get_hash(ponder_board), resets_clock);
+
+        m_thread_pool->set_history(ponder_history);
+        m_thread_pool->start_search(ponder_board, SearchLimits(), m_colour, think_cb, true);
+        return reply;
+    }
+
+    void ponder_hit(const SearchLimits& limits) override
+    {
+        m_thread_pool->ponder_hit(limits);
+    }
+
+    void stop_pondering() override
+    {
+        m_thread_pool->stop();
+        m_thread_pool->wait_for_result();
     }
 };
\ No newline at end of file
@@ -0,0 +1,499 @@
+#include "batch_eval.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "cpu_dispatch.h"
+#include "eval_terms.h"
+#include "piece_square_tables.h"
+#include "utils/board_strings.h"
+
+using namespace eval_terms;
+
+void PositionBatch::add(const BitBoard& board)
+{
+    for (bool white : { true, false })
+    {
+        const uint64_t ours = board.pieces_to_move(white);
+        auto& columns = m_pieces[white ? 0 : 1];
+        columns[static_cast<int>(PieceType::KING)].push_back(board.get_kings() & ours);
+        columns[static_cast<int>(PieceType::QUEEN)].push_back(board.get_queens() & ours);
+        columns[static_cast<int>(PieceType::ROOK)].push_back(board.get_rooks() & ours);
+        columns[static_cast<int>(PieceType::BISHOP)].push_back(board.get_bishops() & ours);
+        columns[static_cast<int>(PieceType::KNIGHT)].push_back(board.get_knights() & ours);
+        columns[static_cast<int>(PieceType::PAWN)].push_back(board.get_pawns() & ours);
+    }
+
+    m_psq.push_back(board.get_psq_score());
+    m_white_to_move.push_back(board.get_colour_to_move() == PieceColour::WHITE);
+}
+
+void PositionBatch::reserve(size_t count)
+{
+    for (auto& colour : m_pieces)
+    {
+        for (auto& column : colour)
+            column.reserve(count);
+    }
+    m_psq.reserve(count);
+    m_white_to_move.reserve(count);
+}
+
+void PositionBatch::clear()
+{
+    for (auto& colour : m_pieces)
+    {
+        for (auto& column : colour)
+            column.clear();
+    }
+    m_psq.clear();
+    m_white_to_move.clear();
+}
+
+// Everything below is branchless and free of table lookups, so that the loops over positions
+// vectorise. Per-piece loops with bit scans, as ShannonHeuristic and BitBoard use, would not.
+
+// Counting bits is most of the work, and neither popcnt nor a 64-bit multiply has a vector form
+// before AVX-512, so counts are taken in two halves built from shifts and adds: bits per byte,
+// then the sum of the bytes. Terms weighting several bitboards add their weighted byte counts
+// first and sum the bytes once, which is fine while no byte can pass 255.
+
+// Number of bits set in each byte
+static inline uint64_t byte_counts(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    return (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+static inline int sum_bytes(uint64_t x)
+{
+    x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL);
+    x += x >> 16;
+    x += x >> 32;
+    return static_cast<int>(x & 0xFFFF);
+}
+
+static inline int popcount(uint64_t x)
+{
+    return sum_bytes(byte_counts(x));
+}
+
+// Shift every square one step in a direction, dropping those that would wrap around a side
+template <int Dir>
+static inline uint64_t shift(uint64_t bb)
+{
+    constexpr uint64_t NOT_A = ~FILE_A, NOT_H = ~FILE_H;
+    if constexpr (Dir == 8)  return bb << 8;
+    if constexpr (Dir == -8) return bb >> 8;
+    if constexpr (Dir == 1)  return (bb << 1) & NOT_A;
+    if constexpr (Dir == -1) return (bb >> 1) & NOT_H;
+    if constexpr (Dir == 9)  return (bb << 9) & NOT_A;
+    if constexpr (Dir == 7)  return (bb << 7) & NOT_H;
+    if constexpr (Dir == -7) return (bb >> 7) & NOT_A;
+    if constexpr (Dir == -9) return (bb >> 9) & NOT_H;
+}
+
+// Squares attacked by all the sliders along one direction: a Kogge-Stone fill through the empty
+// squares, then one step further onto the first blocker. Filling from every slider at once gives
+// the union of their separate rays, as a ray only passes over empty squares.
+template <int Dir>
+static inline uint64_t slide(uint64_t sliders, uint64_t empty)
+{
+    constexpr uint64_t NOT_A = ~FILE_A, NOT_H = ~FILE_H;
+    constexpr int file_step = (Dir + 64) % 8 == 1 ? 1 : (Dir + 64) % 8 == 7 ? -1 : 0;
+    constexpr int d = Dir < 0 ? -Dir : Dir;
+
+    // Squares a ray may pass through, less those it would wrap onto
+    uint64_t pass = empty & (file_step == 1 ? NOT_A : file_step == -1 ? NOT_H : ~0ULL);
+
+    auto step = [](uint64_t bb, int n) { return Dir > 0 ? bb << n : bb >> n; };
+
+    sliders |= pass & step(sliders, d);
+    pass &= step(pass, d);
+    sliders |= pass & step(sliders, 2 * d);
+    pass &= step(pass, 2 * d);
+    sliders |= pass & step(sliders, 4 * d);
+
+    return shift<Dir>(sliders);
+}
+
+static inline uint64_t diagonal_attacks(uint64_t sliders, uint64_t empty)
+{
+    return slide<9>(sliders, empty) | slide<7>(sliders, empty) | slide<-7>(sliders, empty) | slide<-9>(sliders, empty);
+}
+
+static inline uint64_t straight_attacks(uint64_t sliders, uint64_t empty)
+{
+    return slide<8>(sliders, empty) | slide<-8>(sliders, empty) | slide<1>(sliders, empty) | slide<-1>(sliders, empty);
+}
+
+static inline uint64_t knight_attacks(uint64_t knights)
+{
+    uint64_t east = shift<1>(knights), west = shift<-1>(knights);
+    uint64_t attacks = (east | west) << 16 | (east | west) >> 16;
+    east = shift<1>(east);
+    west = shift<-1>(west);
+    return attacks | (east | west) << 8 | (east | west) >> 8;
+}
+
+static inline uint64_t king_attacks(uint64_t king)
+{
+    uint64_t row = king | shift<1>(king) | shift<-1>(king);
+    return (row | row << 8 | row >> 8) & ~king;
+}
+
+// One side's pieces in a position, by PieceType
+struct Side {
+    uint64_t pieces[6];
+
+    uint64_t operator[](PieceType type) const { return pieces[static_cast<int>(type)]; }
+    uint64_t all() const { return pieces[0] | pieces[1] | pieces[2] | pieces[3] | pieces[4] | pieces[5]; }
+};
+
+// Weights of the queen, rook, bishop and knight entries of a Score table, in the order attack
+// maps are kept below
+template <typename Value>
+static constexpr std::array<int, 4> piece_weights(const Score (&table)[6], Value value)
+{
+    std::array<int, 4> weights{};
+    for (int i = 0; i < 4; ++i)
+        weights[i] = value(table[static_cast<int>(PieceType::QUEEN) + i]);
+    return weights;
+}
+
+static constexpr auto MOBILITY_MG = piece_weights(MOBILITY, mg_value);
+static constexpr auto MOBILITY_EG = piece_weights(MOBILITY, eg_value);
+static constexpr auto KING_ZONE_MG = piece_weights(KING_ZONE_ATTACK, [](Score s) { return -mg_value(s); });
+static constexpr auto KING_ZONE_EG = piece_weights(KING_ZONE_ATTACK, [](Score s) { return -eg_value(s); });
+
+//! Sum of weights[i] times the bits in maps[i]
+/*!
+ * A byte of a map holds up to 8 squares, or 3 next to the king, so weights summing to 31 are
+ * safe for mobility and to 85 for king zones.
+ */
+static inline int64_t weighted_count(const uint64_t (&maps)[4], const std::array<int, 4>& weights)
+{
+    uint64_t bytes = 0;
+    for (int i = 0; i < 4; ++i)
+        bytes += static_cast<uint64_t>(weights[i]) * byte_counts(maps[i]);
+    return sum_bytes(bytes);
+}
+
+static_assert(MOBILITY_MG[0] + MOBILITY_MG[1] + MOBILITY_MG[2] + MOBILITY_MG[3] <= 31 &&
+              MOBILITY_EG[0] + MOBILITY_EG[1] + MOBILITY_EG[2] + MOBILITY_EG[3] <= 31 &&
+              MOBILITY_MG[0] >= 0 && MOBILITY_EG[0] >= 0, "mobility weights would overflow a byte count");
+static_assert(KING_ZONE_MG[0] + KING_ZONE_MG[1] + KING_ZONE_MG[2] + KING_ZONE_MG[3] <= 85 &&
+              KING_ZONE_EG[0] + KING_ZONE_EG[1] + KING_ZONE_EG[2] + KING_ZONE_EG[3] <= 85 &&
+              KING_ZONE_MG[3] >= 0 && KING_ZONE_EG[3] >= 0, "king zone weights would overflow a byte count");
+
+// Middlegame and endgame values, unpacked into 64-bit integers like the bitboards. Packed 32-bit
+// Scores would have the vectorised loop convert between element widths at every term.
+struct Value {
+    int64_t mg = 0;
+    int64_t eg = 0;
+
+    void add(Score weight, int64_t count)
+    {
+        mg += mg_value(weight) * count;
+        eg += eg_value(weight) * count;
+    }
+};
+
+// Doubled, isolated and blocked pawns of one side, as ShannonHeuristic counts them
+static inline int64_t pawn_weaknesses(uint64_t pawns, uint64_t blocked)
+{
+    const uint64_t files = file_fill(pawns);
+    const uint64_t isolated = pawns & ~(shift<1>(files) | shift<-1>(files));
+    const int64_t occupied_files = byte_counts(files & 0xFFULL);
+    return sum_bytes(byte_counts(pawns) + byte_counts(isolated) + byte_counts(blocked)) - occupied_files;
+}
+
+// Passed pawn bonuses. With the bits counted per byte, the count on each rank is one byte.
+static inline void add_passed_pawns(Value& value, uint64_t passed, bool white, int sign)
+{
+    const uint64_t by_rank = byte_counts(passed);
+    for (int rank = 1; rank < 7; ++rank)
+        value.add(PASSED_PAWN_BONUS[white ? rank : 7 - rank], sign * static_cast<int64_t>((by_rank >> (8 * rank)) & 0xFF));
+}
+
+// Mobility and king zone attacks of one side, as ShannonHeuristic scores them from attack maps.
+// Attack maps are of queens, rooks, bishops and knights.
+static inline void add_activity(Value& value, int sign, uint64_t our_pieces, uint64_t our_king,
+                                const uint64_t (&our_attacks)[4], const uint64_t (&their_attacks)[4],
+                                uint64_t their_pawn_attacks)
+{
+    const uint64_t area = ~our_pieces & ~their_pawn_attacks;
+    const uint64_t king_zone = king_attacks(our_king);
+
+    const uint64_t mobile[4] = {
+        our_attacks[0] & area, our_attacks[1] & area, our_attacks[2] & area, our_attacks[3] & area
+    };
+    const uint64_t near_king[4] = {
+        their_attacks[0] & king_zone, their_attacks[1] & king_zone,
+        their_attacks[2] & king_zone, their_attacks[3] & king_zone
+    };
+
+    value.mg += sign * (weighted_count(mobile, MOBILITY_MG) - weighted_count(near_king, KING_ZONE_MG));
+    value.eg += sign * (weighted_count(mobile, MOBILITY_EG) - weighted_count(near_king, KING_ZONE_EG));
+}
+
+// Whether a side can't force mate alone: no pawns, queens or rooks, and at most one minor piece
+// or exactly two knights. 1 or 0 rather than a bool, so the kernel needs no branches.
+static inline int64_t cannot_mate(const Side& side)
+{
+    auto is = [](bool condition) { return static_cast<int64_t>(condition); };
+
+    const uint64_t bishops = side[PieceType::BISHOP];
+    const uint64_t knights = side[PieceType::KNIGHT];
+    const uint64_t minors = bishops | knights;
+    const uint64_t second_knight = knights & (knights - 1);
+
+    const int64_t no_heavy = is((side[PieceType::PAWN] | side[PieceType::QUEEN] | side[PieceType::ROOK]) == 0);
+    const int64_t one_minor = is((minors & (minors - 1)) == 0);
+    const int64_t two_knights = is(bishops == 0) & is(second_knight != 0) &
+                                is((second_knight & (second_knight - 1)) == 0);
+    return no_heavy & (one_minor | two_knights);
+}
+
+// Everything but the material and piece-square tables of one position: mg and eg from White's
+// point of view, the game phase, and whether neither side can force mate
+struct Terms {
+    int64_t mg;
+    int64_t eg;
+    int64_t phase;
+    int64_t drawn;
+};
+
+static inline Terms evaluate_terms(const Side& white, const Side& black)
+{
+    using namespace piece_square_tables;
+
+    const uint64_t white_pieces = white.all();
+    const uint64_t black_pieces = black.all();
+    const uint64_t occupied = white_pieces | black_pieces;
+    const uint64_t empty = ~occupied;
+
+    // Material: phase and bishop pairs. Phase weights are small enough to sum per byte.
+    uint64_t phase_bytes = 0;
+    for (PieceType type : { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT })
+        phase_bytes += static_cast<uint64_t>(PHASE_WEIGHT[static_cast<int>(type)]) * byte_counts(white[type] | black[type]);
+
+    auto has_pair = [](uint64_t bishops) { return static_cast<int64_t>((bishops & (bishops - 1)) != 0); };
+
+    Value value;
+    value.add(BISHOP_PAIR, has_pair(white[PieceType::BISHOP]) - has_pair(black[PieceType::BISHOP]));
+
+    // Pawn structure
+    const uint64_t white_pawns = white[PieceType::PAWN];
+    const uint64_t black_pawns = black[PieceType::PAWN];
+    value.add(PAWN_WEAKNESS, pawn_weaknesses(white_pawns, white_pawns & (occupied >> 8))
+                           - pawn_weaknesses(black_pawns, black_pawns & (occupied << 8)));
+    add_passed_pawns(value, white_pawns & ~front_spans(black_pawns, false), true, 1);
+    add_passed_pawns(value, black_pawns & ~front_spans(white_pawns, true), false, -1);
+
+    // Rooks on open and semi-open files
+    const uint64_t open = ~file_fill(white_pawns | black_pawns);
+    const uint64_t white_rooks = white[PieceType::ROOK];
+    const uint64_t black_rooks = black[PieceType::ROOK];
+    value.add(ROOK_OPEN_FILE, popcount(white_rooks & open) - popcount(black_rooks & open));
+    value.add(ROOK_SEMI_OPEN_FILE, popcount(white_rooks & ~file_fill(white_pawns) & ~open)
+                                 - popcount(black_rooks & ~file_fill(black_pawns) & ~open));
+
+    // Mobility and king safety
+    const uint64_t white_attacks[4] = {
+        diagonal_attacks(white[PieceType::QUEEN], empty) | straight_attacks(white[PieceType::QUEEN], empty),
+        straight_attacks(white_rooks, empty),
+        diagonal_attacks(white[PieceType::BISHOP], empty),
+        knight_attacks(white[PieceType::KNIGHT]),
+    };
+    const uint64_t black_attacks[4] = {
+        diagonal_attacks(black[PieceType::QUEEN], empty) | straight_attacks(black[PieceType::QUEEN], empty),
+        straight_attacks(black_rooks, empty),
+        diagonal_attacks(black[PieceType::BISHOP], empty),
+        knight_attacks(black[PieceType::KNIGHT]),
+    };
+    add_activity(value, 1, white_pieces, white[PieceType::KING], white_attacks, black_attacks,
+                 pawn_attacks(black_pawns, false));
+    add_activity(value, -1, black_pieces, black[PieceType::KING], black_attacks, white_attacks,
+                 pawn_attacks(white_pawns, true));
+
+    return { value.mg, value.eg, std::min<int64_t>(sum_bytes(phase_bytes), FULL_PHASE),
+             cannot_mate(white) & cannot_mate(black) };
+}
+
+// Evaluate positions [first, last) a block at a time, in two loops the compiler can vectorise.
+// The first works only on 64-bit values, four to a 256-bit register, as mixing in narrower types
+// would have it handle more positions at once than there are registers for. The second adds the
+// piece-square tables, tapers and scales in 32 bits. The AVX2 version handles twice as many
+// positions per instruction, so it is also built into baseline binaries for the CPUs that have it.
+AVX2_CLONES
+static void evaluate_range(const PositionBatch& positions, size_t first, size_t last, float* scores)
+{
+    using piece_square_tables::FULL_PHASE;
+
+    static constexpr size_t BLOCK = 256;
+
+    const uint64_t* const w[6] = {
+        positions.pieces(true, PieceType::KING), positions.pieces(true, PieceType::QUEEN),
+        positions.pieces(true, PieceType::ROOK), positions.pieces(true, PieceType::BISHOP),
+        positions.pieces(true, PieceType::KNIGHT), positions.pieces(true, PieceType::PAWN),
+    };
+    const uint64_t* const b[6] = {
+        positions.pieces(false, PieceType::KING), positions.pieces(false, PieceType::QUEEN),
+        positions.pieces(false, PieceType::ROOK), positions.pieces(false, PieceType::BISHOP),
+        positions.pieces(false, PieceType::KNIGHT), positions.pieces(false, PieceType::PAWN),
+    };
+    const Score* psq = positions.psq();
+    const uint8_t* white_to_move = positions.white_to_move();
+
+    Terms terms[BLOCK];
+
+    for (size_t block = first; block < last; block += BLOCK)
+    {
+        const size_t count = std::min(BLOCK, last - block);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            const size_t i = block + j;
+            const Side white = { { w[0][i], w[1][i], w[2][i], w[3][i], w[4][i], w[5][i] } };
+            const Side black = { { b[0][i], b[1][i], b[2][i], b[3][i], b[4][i], b[5][i] } };
+            terms[j] = evaluate_terms(white, black);
+        }
+
+        // As taper() on the packed total
+        for (size_t j = 0; j < count; ++j)
+        {
+            const size_t i = block + j;
+            const int mg = static_cast<int>(terms[j].mg) + mg_value(psq[i]);
+            const int eg = static_cast<int>(terms[j].eg) + eg_value(psq[i]);
+            const int phase = static_cast<int>(terms[j].phase);
+            const int centipawns = (mg * phase + eg * (FULL_PHASE - phase)) / FULL_PHASE;
+
+            const int sign = white_to_move[i] ? 1 : -1;
+            scores[i] = terms[j].drawn ? 0.0f : sign * centipawns / 100.0f;
+        }
+    }
+}
+
+void batch_eval::evaluate(const PositionBatch& positions, std::span<float> scores, unsigned threads)
+{
+    if (scores.size() != positions.size())
+        throw std::invalid_argument("Batch evaluation needs one score per position");
+
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Threads below this many positions each cost more to start than they save.
+    static constexpr size_t MIN_PER_THREAD = 4096;
+    threads = static_cast<unsigned>(std::clamp<size_t>(positions.size() / MIN_PER_THREAD, 1, threads));
+
+    const size_t share = (positions.size() + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        const size_t first = t * share;
+        const size_t last = std::min(positions.size(), first + share);
+        workers.emplace_back(evaluate_range, std::cref(positions), first, last, scores.data());
+    }
+    evaluate_range(positions, 0, std::min(positions.size(), share), scores.data());
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+// The line again as EPD: the four position fields, then any operations less "ce". Like
+// board_from_fen(), this takes the third and fourth fields as castling and en passant, if there
+// are any, and skips FEN move counters after them.
+static std::string epd_without_evaluation(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string fields[4] = { "", "", "-", "-" };
+    for (auto& field : fields)
+        in >> field;
+
+    for (int counter = 0; counter < 2; ++counter)
+    {
+        std::streampos before = in.tellg();
+        std::string token;
+        if (!(in >> token) || token.find_first_not_of("0123456789") != std::string::npos)
+        {
+            in.clear();
+            in.seekg(before);
+            break;
+        }
+    }
+
+    std::string epd = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+
+    // Operations end with semicolons, which may also appear in quoted strings.
+    std::string rest, operation;
+    std::getline(in, rest);
+    bool quoted = false;
+    for (char chr : rest)
+    {
+        operation += chr;
+        if (chr == '"')
+            quoted = !quoted;
+        else if (chr == ';' && !quoted)
+        {
+            const size_t start = operation.find_first_not_of(" \t");
+            const size_t end = operation.find_first_of(" \t;", start);
+            if (operation[start] != ';' && operation.compare(start, end - start, "ce") != 0)
+                epd += " " + operation.substr(start);
+            operation.clear();
+        }
+    }
+    return epd;
+}
+
+void batch_eval::evaluate_epd(std::istream& in, std::ostream& out, unsigned threads, std::ostream* errors)
+{
+    static constexpr size_t BATCH_LINES = 1 << 16;
+
+    PositionBatch batch;
+    batch.reserve(BATCH_LINES);
+    std::vector<std::string> lines;
+    std::vector<float> scores;
+
+    auto flush = [&]() {
+        scores.resize(batch.size());
+        evaluate(batch, scores, threads);
+        for (size_t i = 0; i < lines.size(); ++i)
+            out << lines[i] << " ce " << std::lround(scores[i] * 100) << ";\n";
+        batch.clear();
+        lines.clear();
+    };
+
+    std::string line;
+    for (size_t line_number = 1; std::getline(in, line); ++line_number)
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        try
+        {
+            batch.add(utils::board_from_fen<BitBoard>(line));
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::string message = "Line " + std::to_string(line_number) + ": " + e.what();
+            if (!errors)
+                throw std::runtime_error(message);
+
+            *errors << message << std::endl;
+            continue;
+        }
+        lines.push_back(epd_without_evaluation(line));
+
+        if (lines.size() == BATCH_LINES)
+            flush();
+    }
+    flush();
+    out.flush();
+}
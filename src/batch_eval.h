@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "bitboards/bitboard.h"
+#include "score.h"
+
+// Many positions for the handwritten evaluation, laid out column by column: one array per
+// bitboard, so a kernel can load the same bitboard of several positions at once.
+class PositionBatch
+{
+private:
+    std::vector<uint64_t> m_pieces[2][6];   // by colour (white first) and PieceType
+    std::vector<Score> m_psq;
+    std::vector<uint8_t> m_white_to_move;
+
+public:
+    //! Append a position
+    void add(const BitBoard& board);
+
+    void reserve(size_t count);
+    void clear();
+
+    size_t size() const { return m_psq.size(); }
+
+    //! Pieces of one colour and type in each position
+    const uint64_t* pieces(bool white, PieceType type) const { return m_pieces[white ? 0 : 1][static_cast<int>(type)].data(); }
+
+    //! Material and piece-square table values, as BitBoard::get_psq_score()
+    const Score* psq() const { return m_psq.data(); }
+
+    const uint8_t* white_to_move() const { return m_white_to_move.data(); }
+};
+
+namespace batch_eval
+{
+    //! Evaluate every position in a batch, as ShannonHeuristic would for the side to move
+    /*!
+     * Positions are split between threads, and each thread works through its share a block at a
+     * time with loops the compiler can vectorise, using AVX2 where the CPU has it. Scores are
+     * exactly ShannonHeuristic's, whether or not the boards had generated moves.
+     *
+     * \param scores one per position, in pawns from the side to move's point of view
+     * \param threads number of threads, or 0 for one per hardware thread
+     */
+    void evaluate(const PositionBatch& positions, std::span<float> scores, unsigned threads = 1);
+
+    //! Score every position in an EPD or FEN stream
+    /*!
+     * Each line is written back as EPD, the first four FEN fields and any operations, with a
+     * "ce" (centipawn evaluation) operation for the side to move replacing any already there.
+     * Blank lines are skipped. Positions are read and evaluated a batch at a time.
+     *
+     * \param errors if given, lines that aren't a valid position are reported here and skipped
+     * \throw std::runtime_error if a line isn't a valid position and there is no errors stream
+     */
+    void evaluate_epd(std::istream& in, std::ostream& out, unsigned threads = 1, std::ostream* errors = nullptr);
+}
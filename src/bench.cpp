@@ -0,0 +1,325 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch_eval.h"
+#include "heuristic.h"
+#include "search_thread_pool.h"
+#include "utils/board_strings.h"
+
+// Start position plus the perft suite's middlegame positions
+static std::vector<BitBoard> bench_positions()
+{
+    std::vector<BitBoard> positions;
+
+    BitBoard start;
+    start.set_to_start_position();
+    positions.push_back(start);
+
+    positions.push_back(utils::board_from_string_repr<BitBoard>(
+        " r _ _ _ k _ _ r\n"
+        " p _ p p q p b _\n"
+        " b n _ _ p n p _\n"
+        " _ _ _ P N _ _ _\n"
+        " _ p _ _ P _ _ _\n"
+        " _ _ N _ _ Q _ p\n"
+        " P P P B B P P P\n"
+        " R _ _ _ K _ _ R\n"
+        "w KQkq - 1 8\n"));
+
+    positions.push_back(utils::board_from_string_repr<BitBoard>(
+        " r _ _ _ k _ _ r\n"
+        " P p p p _ p p p\n"
+        " _ b _ _ _ n b N\n"
+        " n P _ _ _ _ _ _\n"
+        " B B P _ P _ _ _\n"
+        " q _ _ _ _ N _ _\n"
+        " P p _ P _ _ P P\n"
+        " R _ _ Q _ R K _\n"
+        "w kq - 0 0\n"));
+
+    positions.push_back(utils::board_from_string_repr<BitBoard>(
+        " r n b q _ k _ r\n"
+        " p p _ P b p p p\n"
+        " _ _ p _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ B _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " P P P _ N n P P\n"
+        " R N B Q K _ _ R\n"
+        "w KQ - 1 8\n"));
+
+    return positions;
+}
+
+struct TimeToDepth
+{
+    double ms = 0.0;
+    uint64_t nodes = 0;
+    HashStats pawn_hash;
+    HashStats material_hash;
+    HashStats eval_cache;
+    EvalStats evals;
+};
+
+// Search every position to the given depth from a cold TT and total the time and nodes taken
+static TimeToDepth time_to_depth(SearchThreadPool& pool, const std::vector<BitBoard>& positions, uint8_t depth)
+{
+    using namespace std::chrono;
+
+    TimeToDepth total;
+
+    for (const auto& board : positions)
+    {
+        // Each position starts cold so runs with different thread counts are comparable.
+        pool.clear_hash();
+
+        SearchLimits limits;
+        limits.max_depth = depth;
+
+        pool.start_search(board, limits, board.get_colour_to_move());
+        pool.wait_for_result();
+
+        total.ms += duration<double, std::milli>(steady_clock::now() - limits.start).count();
+        total.nodes += pool.nodes_searched();
+        total.pawn_hash += pool.pawn_hash_stats();
+        total.material_hash += pool.material_hash_stats();
+        total.eval_cache += pool.eval_cache_stats();
+        total.evals += pool.eval_stats();
+    }
+
+    return total;
+}
+
+static const unsigned BENCH_THREADS[] = { 1, 2, 4, 8, 16 };
+
+void bench::run_smp(std::ostream& out, uint8_t depth)
+{
+    auto positions = bench_positions();
+    SearchThreadPool pool(1);
+
+    out << "Lazy SMP time-to-depth " << static_cast<int>(depth)
+        << " over " << positions.size() << " positions" << std::endl;
+    out << std::setw(8) << "threads" << std::setw(12) << "time(ms)" << std::setw(10) << "speedup"
+        << std::setw(14) << "nodes" << std::setw(10) << "knps" << std::setw(11) << "pawn hit%"
+        << std::setw(11) << "mat hit%" << std::setw(11) << "eval hit%"
+        << std::setw(8) << "lazy%" << std::endl;
+
+    double base_ms = 0.0;
+
+    for (unsigned threads : BENCH_THREADS)
+    {
+        pool.resize(threads);
+        TimeToDepth result = time_to_depth(pool, positions, depth);
+
+        if (threads == 1)
+            base_ms = result.ms;
+
+        out << std::setw(8) << threads
+            << std::setw(12) << std::fixed << std::setprecision(0) << result.ms
+            << std::setw(10) << std::setprecision(2) << base_ms / result.ms
+            << std::setw(14) << result.nodes
+            << std::setw(10) << std::setprecision(0) << result.nodes / std::max(result.ms, 1.0)
+            << std::setw(11) << std::setprecision(1) << result.pawn_hash.hit_rate()
+            << std::setw(11) << result.material_hash.hit_rate()
+            << std::setw(11) << result.eval_cache.hit_rate()
+            << std::setw(8) << result.evals.lazy_rate()
+            << std::endl;
+    }
+}
+
+void bench::run_parallel(std::ostream& out, uint8_t depth)
+{
+    auto positions = bench_positions();
+    SearchThreadPool pool(1);
+
+    out << "Lazy SMP vs ABDADA time-to-depth " << static_cast<int>(depth)
+        << " over " << positions.size() << " positions" << std::endl;
+    out << std::setw(8) << "threads"
+        << std::setw(12) << "lazy(ms)" << std::setw(10) << "speedup" << std::setw(14) << "nodes"
+        << std::setw(12) << "abdada(ms)" << std::setw(10) << "speedup" << std::setw(14) << "nodes"
+        << std::endl;
+
+    // Both modes are identical on one thread, so share a single baseline.
+    double base_ms = 0.0;
+
+    for (unsigned threads : BENCH_THREADS)
+    {
+        pool.resize(threads);
+
+        pool.set_mode(ParallelMode::LAZY_SMP);
+        TimeToDepth lazy = time_to_depth(pool, positions, depth);
+
+        pool.set_mode(ParallelMode::ABDADA);
+        TimeToDepth abdada = time_to_depth(pool, positions, depth);
+
+        if (threads == 1)
+            base_ms = lazy.ms;
+
+        out << std::setw(8) << threads << std::fixed
+            << std::setw(12) << std::setprecision(0) << lazy.ms
+            << std::setw(10) << std::setprecision(2) << base_ms / lazy.ms
+            << std::setw(14) << lazy.nodes
+            << std::setw(12) << std::setprecision(0) << abdada.ms
+            << std::setw(10) << std::setprecision(2) << base_ms / abdada.ms
+            << std::setw(14) << abdada.nodes
+            << std::endl;
+    }
+}
+
+// Positions reached by random moves from each bench position
+static std::vector<BitBoard> eval_positions()
+{
+    std::vector<BitBoard> positions;
+    std::mt19937 rng(2024);
+
+    for (const auto& start : bench_positions())
+    {
+        for (int game = 0; game < 4; ++game)
+        {
+            BitBoard board(start);
+            for (int ply = 0; ply < 100; ++ply)
+            {
+                auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+                if (moves.empty())
+                    break;
+                board.make_move(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)]);
+                positions.push_back(board);
+            }
+        }
+    }
+
+    return positions;
+}
+
+void bench::run_eval(std::ostream& out, std::shared_ptr<const nnue::Network> network)
+{
+    using namespace std::chrono;
+
+    static constexpr int PASSES = 200;
+
+    auto positions = eval_positions();
+
+    out << "Evaluation speed over " << positions.size() << " positions from random games" << std::endl;
+    out << std::setw(24) << "evaluator" << std::setw(14) << "evals/s" << std::setw(10) << "ns/eval" << std::endl;
+
+    // Scores are summed so the evaluations can't be optimised away.
+    volatile float sink = 0.f;
+
+    // Each pass gets fresh copies, so the boards work out their attack maps every time rather than
+    // reuse those cached by the previous pass. Copying isn't timed.
+    auto measure = [&](const std::string& name, const std::function<float(const BitBoard&)>& eval) {
+        double ns = 0.0;
+        float sum = 0.f;
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            std::vector<BitBoard> fresh(positions);
+            auto start = steady_clock::now();
+            for (const auto& board : fresh)
+                sum += eval(board);
+            ns += duration<double, std::nano>(steady_clock::now() - start).count();
+        }
+        sink = sink + sum;
+
+        double evals = double(PASSES) * positions.size();
+        out << std::setw(24) << name << std::fixed
+            << std::setw(14) << std::setprecision(0) << evals / ns * 1e9
+            << std::setw(10) << std::setprecision(1) << ns / evals << std::endl;
+    };
+
+    measure("ShannonHeuristic", [](const BitBoard& board) {
+        return ShannonHeuristic(board, board.get_colour_to_move()).get();
+    });
+
+    EvalTables tables;
+    measure("  + eval tables", [&](const BitBoard& board) {
+        return ShannonHeuristic(board, board.get_colour_to_move(), &tables).get();
+    });
+
+    // As in quiescence search with a null window at 0
+    measure("  + lazy, window 0", [&](const BitBoard& board) {
+        return ShannonHeuristic(board, board.get_colour_to_move(), -0.01f, 0.f, &tables).get();
+    });
+
+    if (network)
+    {
+        for (auto& board : positions)
+            board.set_network(network);
+
+        measure("NNUE", [](const BitBoard& board) {
+            return board.get_accumulator()->evaluate(board.get_colour_to_move() == PieceColour::WHITE) / 100.0f;
+        });
+    }
+}
+
+void bench::run_batch(std::ostream& out)
+{
+    using namespace std::chrono;
+
+    static constexpr int PASSES = 64;
+
+    auto positions = eval_positions();
+    const double evals = double(PASSES) * positions.size();
+
+    out << "Batch evaluation over " << PASSES << " x " << positions.size() << " positions from random games"
+        << std::endl;
+    out << std::setw(24) << "evaluator" << std::setw(14) << "evals/s" << std::setw(10) << "ns/eval"
+        << std::setw(10) << "speedup" << std::endl;
+
+    double base_ns = 0.0;
+    auto report = [&](const std::string& name, double ns) {
+        if (base_ns == 0.0)
+            base_ns = ns;
+        out << std::setw(24) << name << std::fixed
+            << std::setw(14) << std::setprecision(0) << evals / ns * 1e9
+            << std::setw(10) << std::setprecision(1) << ns / evals
+            << std::setw(10) << std::setprecision(2) << base_ns / ns << std::endl;
+    };
+
+    // Scores are summed so the evaluations can't be optimised away.
+    volatile float sink = 0.f;
+
+    // Each pass gets fresh copies, so the boards work out their attack maps as they would when
+    // read from a file, rather than reuse those of the previous pass. Copying isn't timed.
+    double ns = 0.0;
+    float sum = 0.f;
+    for (int pass = 0; pass < PASSES; ++pass)
+    {
+        std::vector<BitBoard> fresh(positions);
+        auto start = steady_clock::now();
+        for (const auto& board : fresh)
+            sum += ShannonHeuristic(board, board.get_colour_to_move()).get();
+        ns += duration<double, std::nano>(steady_clock::now() - start).count();
+    }
+    sink = sink + sum;
+    report("ShannonHeuristic loop", ns);
+
+    PositionBatch batch;
+    batch.reserve(PASSES * positions.size());
+    for (int pass = 0; pass < PASSES; ++pass)
+    {
+        for (const auto& board : positions)
+            batch.add(board);
+    }
+    std::vector<float> scores(batch.size());
+
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : { 1u, hardware_threads })
+    {
+        auto start = steady_clock::now();
+        batch_eval::evaluate(batch, scores, threads);
+        ns = duration<double, std::nano>(steady_clock::now() - start).count();
+        sink = sink + scores.back();
+
+        report("batch, " + std::to_string(threads) + (threads == 1 ? " thread" : " threads"), ns);
+        if (hardware_threads == 1)
+            break;
+    }
+}
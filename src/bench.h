@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "nnue.h"
+
+namespace bench
+{
+    //! Measure Lazy SMP time-to-depth over a fixed set of positions at 1, 2, 4, 8 and 16 threads
+    /*!
+     * \param out stream to write the results table to
+     * \param depth depth each position is searched to
+     */
+    void run_smp(std::ostream& out, uint8_t depth);
+
+    //! Compare Lazy SMP and ABDADA time-to-depth over the same positions and thread counts
+    /*!
+     * \param out stream to write the results table to
+     * \param depth depth each position is searched to
+     */
+    void run_parallel(std::ostream& out, uint8_t depth);
+
+    //! Measure evaluations per second over positions from random games, with each evaluator
+    /*!
+     * \param out stream to write the results table to
+     * \param network network to include in the comparison, if any
+     */
+    void run_eval(std::ostream& out, std::shared_ptr<const nnue::Network> network);
+
+    //! Compare batch evaluation, on one thread and on every hardware thread, with a loop of
+    //! ShannonHeuristic constructors over the same positions
+    /*!
+     * \param out stream to write the results table to
+     */
+    void run_batch(std::ostream& out);
+}
@@ -4,8 +4,37 @@
 
 #include "bitboard_ray_attacks.h"
 
+#include <eval_terms.h>
+#include <material_table.h>
+#include <piece_square_tables.h>
+
 using namespace bitboard_utils;
 
+static PieceType promoted_piece_type(Move::PromotionType promotion)
+{
+    // Indexed by PromotionType
+    static constexpr PieceType PROMOTED[] = { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT };
+    return PROMOTED[static_cast<int>(promotion)];
+}
+
+// Random keys for a pawn of each colour (white first) on each square, making up the pawn key
+static constexpr auto PAWN_KEYS = [] {
+    std::array<std::array<uint64_t, 64>, 2> keys{};
+    uint64_t state = 0x7061776E6B657973ULL;
+    for (auto& colour_keys : keys)
+    {
+        for (auto& key : colour_keys)
+        {
+            // splitmix64
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+    }
+    return keys;
+}();
+
 BitBoard::BitBoard() :
     m_pawns(0),
     m_knights(0),
@@ -35,8 +64,14 @@ BitBoard::BitBoard(const BitBoard& orig) :
     m_white_pieces(orig.m_white_pieces),
     m_black_pieces(orig.m_black_pieces),
     m_occupied(orig.m_occupied),
+    m_psq(orig.m_psq),
+    m_pawn_key(orig.m_pawn_key),
+    m_material_key(orig.m_material_key),
+    m_accumulator(orig.m_accumulator),
     m_opposite_attacks(orig.m_opposite_attacks),
     m_current_attacks(orig.m_current_attacks),
+    m_attack_maps(orig.m_attack_maps),
+    m_attack_maps_valid(orig.m_attack_maps_valid),
     m_white_to_move(orig.m_white_to_move),
     m_allowed_moves(orig.m_allowed_moves),
     m_new_allowed_moves(orig.m_new_allowed_moves),
@@ -53,6 +88,35 @@ BitBoard::BitBoard(const BitBoard& orig) :
 {
 }
 
+BitBoard& BitBoard::operator=(const BitBoard& orig)
+{
+    // piece_map points at this board's own members, so it is left alone
+    m_pawns = orig.m_pawns;
+    m_knights = orig.m_knights;
+    m_bishops = orig.m_bishops;
+    m_rooks = orig.m_rooks;
+    m_queens = orig.m_queens;
+    m_kings = orig.m_kings;
+    m_white_pieces = orig.m_white_pieces;
+    m_black_pieces = orig.m_black_pieces;
+    m_occupied = orig.m_occupied;
+    m_psq = orig.m_psq;
+    m_pawn_key = orig.m_pawn_key;
+    m_material_key = orig.m_material_key;
+    m_accumulator = orig.m_accumulator;
+    m_opposite_attacks = orig.m_opposite_attacks;
+    m_current_attacks = orig.m_current_attacks;
+    m_attack_maps = orig.m_attack_maps;
+    m_attack_maps_valid = orig.m_attack_maps_valid;
+    m_white_to_move = orig.m_white_to_move;
+    m_allowed_moves = orig.m_allowed_moves;
+    m_new_allowed_moves = orig.m_new_allowed_moves;
+    m_castling_rights = orig.m_castling_rights;
+    m_en_passant_col = orig.m_en_passant_col;
+
+    return *this;
+}
+
 void BitBoard::set_to_start_position()
 {
     m_pawns   = 0x00ff0000'0000ff00;
@@ -68,6 +132,8 @@ void BitBoard::set_to_start_position()
     m_occupied = 0xffff0000'0000ffff;
 
     m_white_to_move = 1;
+
+    refresh_eval_terms();
 }
 
 void BitBoard::set_from_edit_mode(std::vector<std::string> edit_mode_strings)
@@ -382,11 +448,13 @@ BitBoard::MoveList& BitBoard::get_all_legal_moves() const
     uint64_t new_opposite_attacks = 0;
     m_new_allowed_moves = 0xffffffff'ffffffff;
 
-    new_opposite_attacks |= get_knight_moves<NonMoving>(ret, 0);
-    
-    new_opposite_attacks |= enemy_ray_attacks.get_bishop_moves(ret);
-    new_opposite_attacks |= enemy_ray_attacks.get_rook_moves(ret);
-    new_opposite_attacks |= enemy_ray_attacks.get_queen_moves(ret);
+    const uint64_t enemy_knights = get_knight_moves<NonMoving>(ret, 0);
+    const uint64_t enemy_bishops = enemy_ray_attacks.get_bishop_moves(ret);
+    const uint64_t enemy_rooks = enemy_ray_attacks.get_rook_moves(ret);
+    const uint64_t enemy_queens = enemy_ray_attacks.get_queen_moves(ret);
+    set_attack_maps(NonMoving, enemy_knights, enemy_bishops, enemy_rooks, enemy_queens);
+
+    new_opposite_attacks |= enemy_knights | enemy_bishops | enemy_rooks | enemy_queens;
 
     new_opposite_attacks |= enemy_ray_attacks.get_king_attacks();
 
@@ -407,11 +475,20 @@ BitBoard::MoveList& BitBoard::get_all_legal_moves() const
     
     m_current_attacks = 0;
 
-    m_current_attacks |= get_knight_moves<Moving>(ret, pinned);
+    const uint64_t knights = get_knight_moves<Moving>(ret, pinned);
+    const uint64_t bishops = friendly_ray_attacks.get_bishop_moves(ret);
+    const uint64_t rooks = friendly_ray_attacks.get_rook_moves(ret);
+    const uint64_t queens = friendly_ray_attacks.get_queen_moves(ret);
+
+    // Pinned pieces only move along their pin, but the evaluation counts everything they attack.
+    const uint64_t our_pinned = pinned & pieces_to_move(Moving);
+    set_attack_maps(Moving, knights | piece_attacks(PieceType::KNIGHT, m_knights & our_pinned),
+                    bishops | piece_attacks(PieceType::BISHOP, m_bishops & our_pinned),
+                    rooks | piece_attacks(PieceType::ROOK, m_rooks & our_pinned),
+                    queens | piece_attacks(PieceType::QUEEN, m_queens & our_pinned));
+    m_attack_maps_valid = true;
 
-    m_current_attacks |= friendly_ray_attacks.get_bishop_moves(ret);
-    m_current_attacks |= friendly_ray_attacks.get_rook_moves(ret);
-    m_current_attacks |= friendly_ray_attacks.get_queen_moves(ret);
+    m_current_attacks |= knights | bishops | rooks | queens;
 
     m_current_attacks |= friendly_ray_attacks.get_king_attacks();
 
@@ -435,6 +512,58 @@ BitBoard::MoveList& BitBoard::get_all_legal_moves(PieceColour col) const
     return col == PieceColour::WHITE ? get_all_legal_moves<true>() : get_all_legal_moves<false>();
 }
 
+// Pawn and king attacks are simple enough to work out here rather than take from move generation,
+// whose pawn moves include pushes and whose king moves leave out attacked squares.
+void BitBoard::set_attack_maps(bool white, uint64_t knights, uint64_t bishops, uint64_t rooks, uint64_t queens) const
+{
+    const uint64_t ours = white ? m_white_pieces : m_black_pieces;
+    const uint64_t king = m_kings & ours;
+
+    AttackMaps& maps = m_attack_maps[white ? 0 : 1];
+    maps[static_cast<int>(PieceType::PAWN)] = eval_terms::pawn_attacks(m_pawns & ours, white);
+    maps[static_cast<int>(PieceType::KNIGHT)] = knights;
+    maps[static_cast<int>(PieceType::BISHOP)] = bishops;
+    maps[static_cast<int>(PieceType::ROOK)] = rooks;
+    maps[static_cast<int>(PieceType::QUEEN)] = queens;
+    maps[static_cast<int>(PieceType::KING)] = king ? king_attack_lut[bit_scan_forward(king)] : 0;
+}
+
+uint64_t BitBoard::piece_attacks(PieceType type, uint64_t pieces) const
+{
+    uint64_t attacks = 0;
+    for (; pieces; pieces &= pieces - 1)
+    {
+        const uint8_t sq = bit_scan_forward(pieces);
+        switch (type)
+        {
+            case PieceType::KNIGHT: attacks |= knight_attack_lut[sq]; break;
+            case PieceType::BISHOP: attacks |= bishop_attacks(sq, m_occupied); break;
+            case PieceType::ROOK:   attacks |= rook_attacks(sq, m_occupied); break;
+            case PieceType::QUEEN:  attacks |= bishop_attacks(sq, m_occupied) | rook_attacks(sq, m_occupied); break;
+            default: break;
+        }
+    }
+    return attacks;
+}
+
+const BitBoard::AttackMaps& BitBoard::get_attack_maps(bool white) const
+{
+    if (!m_attack_maps_valid)
+    {
+        for (bool colour : { true, false })
+        {
+            const uint64_t ours = colour ? m_white_pieces : m_black_pieces;
+            set_attack_maps(colour, piece_attacks(PieceType::KNIGHT, m_knights & ours),
+                            piece_attacks(PieceType::BISHOP, m_bishops & ours),
+                            piece_attacks(PieceType::ROOK, m_rooks & ours),
+                            piece_attacks(PieceType::QUEEN, m_queens & ours));
+        }
+        m_attack_maps_valid = true;
+    }
+
+    return m_attack_maps[white ? 0 : 1];
+}
+
 bool BitBoard::add_piece(PieceType type, PieceColour col, BoardLocation loc)
 {    
     auto mask = loc.to_bitboard_mask();
@@ -482,6 +611,8 @@ bool BitBoard::add_piece(PieceType type, PieceColour col, BoardLocation loc)
         break;
     }
 
+    add_eval_terms(type, col == PieceColour::WHITE, loc.get_raw(), 1);
+
     return true;
 }
 
@@ -516,6 +647,15 @@ bool BitBoard::make_move(const Move& move)
     const auto& curr_loc = move.get_from_loc();
     const auto curr_loc_mask = curr_loc.to_bitboard_mask();
 
+    // Update the evaluation totals while the captured piece is still on the board
+    {
+        const PieceType moved = piece_type_at(curr_loc_mask);
+        const bool is_capture = m_occupied & new_loc_mask;
+        const bool en_passant = moved == PieceType::PAWN && !is_capture && curr_loc.get_x() != new_loc.get_x();
+        update_eval_terms(move, moved, is_capture ? std::optional(piece_type_at(new_loc_mask)) : std::nullopt,
+                          en_passant, m_white_pieces & curr_loc_mask, 1);
+    }
+
     // Remove piece at new_loc
     uint64_t was_occupied = m_occupied;
     for (auto piece_set : { &m_occupied, &m_white_pieces, &m_black_pieces, &m_pawns, &m_knights, &m_bishops, &m_rooks, &m_queens, &m_kings })
@@ -675,6 +815,10 @@ bool BitBoard::unmake_move(const Move& move)
     const auto& curr_loc = move.get_from_loc();
     const auto curr_loc_mask = curr_loc.to_bitboard_mask();
 
+    update_eval_terms(move, move.get_promotion_type() ? PieceType::PAWN : piece_type_at(new_loc_mask),
+                      move.get_captured_piece_type(), move.is_en_passant_capture(),
+                      m_white_pieces & new_loc_mask, -1);
+
     // en passant rules
     if (move.is_en_passant_capture())
     {
@@ -803,4 +947,234 @@ bool BitBoard::unmake_move(const Move& move)
     m_white_to_move = !m_white_to_move;
 
     return true;
-}
\ No newline at end of file
+}
+
+PieceType BitBoard::piece_type_at(uint64_t mask) const
+{
+    for (const auto& [pieces, type] : piece_map)
+    {
+        if (*pieces & mask)
+            return type;
+    }
+    return PieceType::KING;
+}
+
+void BitBoard::add_eval_terms(PieceType type, bool white, uint8_t sq, int sign)
+{
+    using namespace piece_square_tables;
+
+    const int t = static_cast<int>(type);
+
+    // Every change to the pieces comes through here, so the attack maps are stale now.
+    m_attack_maps_valid = false;
+
+    m_psq += (white ? sign : -sign) * PIECE_SQUARE[t][table_square(sq, white)];
+
+    if (sign > 0)
+        m_material_key += material_key::unit(type, white);
+    else
+        m_material_key -= material_key::unit(type, white);
+
+    // Adding and removing a key are the same
+    if (type == PieceType::PAWN)
+        m_pawn_key ^= PAWN_KEYS[white ? 0 : 1][sq];
+
+    if (m_accumulator)
+        m_accumulator->update(type, white, sq, sign);
+}
+
+// Apply (sign 1) or take back (sign -1) a move's change to the evaluation totals. The moved piece,
+// its colour and any capture are passed in, as make_move() and unmake_move() find them differently.
+void BitBoard::update_eval_terms(const Move& move, PieceType moved, std::optional<PieceType> captured, bool en_passant,
+                                 bool white, int sign)
+{
+    const uint8_t from = move.get_from_loc().get_raw();
+    const uint8_t to = move.get_to_loc().get_raw();
+
+    add_eval_terms(moved, white, from, -sign);
+    add_eval_terms(move.get_promotion_type() ? promoted_piece_type(*move.get_promotion_type()) : moved, white, to, sign);
+
+    if (en_passant)
+        add_eval_terms(PieceType::PAWN, !white, white ? to - 8 : to + 8, -sign);
+    else if (captured)
+        add_eval_terms(*captured, !white, to, -sign);
+
+    // Castling also moves the rook, from the corner to the far side of the king.
+    if (moved == PieceType::KING && (from & 7) == 4 && ((to & 7) == 6 || (to & 7) == 2))
+    {
+        const bool kingside = (to & 7) == 6;
+        add_eval_terms(PieceType::ROOK, white, kingside ? to + 1 : to - 2, -sign);
+        add_eval_terms(PieceType::ROOK, white, kingside ? to - 1 : to + 1, sign);
+    }
+}
+
+void BitBoard::set_network(std::shared_ptr<const nnue::Network> network)
+{
+    if (!network)
+    {
+        m_accumulator.reset();
+        return;
+    }
+
+    m_accumulator.emplace(std::move(network));
+    refresh_eval_terms();
+}
+
+void BitBoard::refresh_eval_terms()
+{
+    m_psq = 0;
+    m_pawn_key = 0;
+    m_material_key = 0;
+    if (m_accumulator)
+        m_accumulator->clear();
+
+    for (const auto& [pieces, type] : piece_map)
+    {
+        for (bool white : { true, false })
+        {
+            uint64_t remaining = *pieces & (white ? m_white_pieces : m_black_pieces);
+            while (remaining)
+            {
+                add_eval_terms(type, white, bit_scan_forward(remaining), 1);
+                remaining &= remaining - 1;
+            }
+        }
+    }
+}
+
+uint64_t BitBoard::attackers_to(uint8_t sq, uint64_t occupied) const
+{
+    static constexpr uint64_t FILE_A = 0x01010101'01010101;
+    static constexpr uint64_t FILE_H = 0x80808080'80808080;
+
+    uint64_t sq_mask = 1ULL << sq;
+
+    // A pawn attacks sq if a pawn of the other colour on sq would attack it.
+    uint64_t white_pawns = (((sq_mask >> 7) & ~FILE_A) | ((sq_mask >> 9) & ~FILE_H)) & m_pawns & m_white_pieces;
+    uint64_t black_pawns = (((sq_mask << 7) & ~FILE_H) | ((sq_mask << 9) & ~FILE_A)) & m_pawns & m_black_pieces;
+
+    return white_pawns | black_pawns
+        | (knight_attack_lut[sq] & m_knights)
+        | (king_attack_lut[sq] & m_kings)
+        | (bishop_attacks(sq, occupied) & (m_bishops | m_queens))
+        | (rook_attacks(sq, occupied) & (m_rooks | m_queens));
+}
+
+bool BitBoard::gives_check(const Move& move) const
+{
+    static constexpr uint64_t FILE_A = 0x01010101'01010101;
+    static constexpr uint64_t FILE_H = 0x80808080'80808080;
+
+    const uint64_t from_mask = move.get_from_loc().to_bitboard_mask();
+    const uint64_t to_mask = move.get_to_loc().to_bitboard_mask();
+    const uint8_t to = move.get_to_loc().get_raw();
+
+    const bool white = from_mask & m_white_pieces;
+    const uint64_t their_king = m_kings & (white ? m_black_pieces : m_white_pieces);
+    if (!their_king)
+        return false;
+
+    const uint8_t king_sq = bit_scan_forward(their_king);
+    const uint64_t occupied = (m_occupied & ~from_mask) | to_mask;
+
+    // Discovered check: one of our other sliders now sees the king.
+    const uint64_t ours = (white ? m_white_pieces : m_black_pieces) & ~from_mask;
+    if ((bishop_attacks(king_sq, occupied) & (m_bishops | m_queens) & ours)
+        || (rook_attacks(king_sq, occupied) & (m_rooks | m_queens) & ours))
+    {
+        return true;
+    }
+
+    // Direct check by the moved (or promoted) piece from its new square.
+    PieceType moved = piece_type_at(from_mask);
+    if (move.get_promotion_type())
+        moved = promoted_piece_type(*move.get_promotion_type());
+
+    switch (moved)
+    {
+    case PieceType::PAWN:
+        return their_king & (white ? (((to_mask << 7) & ~FILE_H) | ((to_mask << 9) & ~FILE_A))
+                                   : (((to_mask >> 7) & ~FILE_A) | ((to_mask >> 9) & ~FILE_H)));
+    case PieceType::KNIGHT:
+        return their_king & knight_attack_lut[to];
+    case PieceType::BISHOP:
+        return their_king & bishop_attacks(to, occupied);
+    case PieceType::ROOK:
+        return their_king & rook_attacks(to, occupied);
+    case PieceType::QUEEN:
+        return their_king & (bishop_attacks(to, occupied) | rook_attacks(to, occupied));
+    case PieceType::KING:
+        return false;
+    }
+    return false;
+}
+
+int BitBoard::see(const Move& move) const
+{
+    // Indexed by PieceType
+    static constexpr int SEE_VALUES[] = { 20000, 900, 500, 300, 300, 100 };
+
+    const uint8_t to = move.get_to_loc().get_raw();
+    const uint64_t from_mask = move.get_from_loc().to_bitboard_mask();
+    const uint64_t to_mask = 1ULL << to;
+
+    uint64_t occupied = m_occupied ^ from_mask;
+    PieceType attacker = piece_type_at(from_mask);
+
+    // Gain for the side making each capture in the sequence, assuming it is recaptured
+    std::array<int, 32> gain{};
+    if (m_occupied & to_mask)
+    {
+        gain[0] = SEE_VALUES[static_cast<int>(piece_type_at(to_mask))];
+    }
+    else if (attacker == PieceType::PAWN && move.get_from_loc().get_x() != move.get_to_loc().get_x())
+    {
+        // En passant: the captured pawn is beside the target square, not on it.
+        gain[0] = SEE_VALUES[static_cast<int>(PieceType::PAWN)];
+        occupied ^= (from_mask & m_white_pieces) ? to_mask >> 8 : to_mask << 8;
+    }
+
+    int attacker_value = SEE_VALUES[static_cast<int>(attacker)];
+    if (move.get_promotion_type())
+    {
+        attacker_value = SEE_VALUES[static_cast<int>(promoted_piece_type(*move.get_promotion_type()))];
+        gain[0] += attacker_value - SEE_VALUES[static_cast<int>(PieceType::PAWN)];
+    }
+
+    bool white = from_mask & m_white_pieces;
+    uint64_t attackers = attackers_to(to, occupied) & occupied;
+
+    size_t depth = 0;
+    while (depth + 1 < gain.size())
+    {
+        white = !white;
+        uint64_t own_attackers = attackers & (white ? m_white_pieces : m_black_pieces);
+        if (!own_attackers)
+            break;
+
+        ++depth;
+        gain[depth] = attacker_value - gain[depth - 1];
+
+        // Recapture with the least valuable attacker (piece_map runs from pawns to kings),
+        // revealing any slider behind it.
+        for (const auto& [pieces, type] : piece_map)
+        {
+            uint64_t of_type = own_attackers & *pieces;
+            if (of_type)
+            {
+                occupied ^= of_type & -of_type;
+                attacker_value = SEE_VALUES[static_cast<int>(type)];
+                break;
+            }
+        }
+        attackers = attackers_to(to, occupied) & occupied;
+    }
+
+    // Each side may stop recapturing once it is ahead.
+    while (depth > 0)
+    {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+    return gain[0];
+}
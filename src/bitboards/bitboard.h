@@ -5,13 +5,18 @@
 #include <boost/container/static_vector.hpp>
 
 #include <move.h>
+#include <nnue.h>
 #include <piece_types.h>
+#include <score.h>
 
 class BitBoard
 {
 public:
     using MoveList = boost::container::static_vector<Move, 256>;
 
+    //! Squares attacked by one colour's pieces of each type, indexed by PieceType
+    using AttackMaps = std::array<uint64_t, 6>;
+
     enum Mate {
         CHECKMATE,
         STALEMATE,
@@ -29,9 +34,19 @@ private:
     uint64_t m_pawns, m_knights, m_bishops, m_rooks, m_queens, m_kings;
     uint64_t m_black_pieces, m_white_pieces, m_occupied;
 
+    // Running evaluation totals, kept up to date as pieces are added and moved
+    Score m_psq = 0;            // material and piece-square tables, white's less black's
+    uint64_t m_pawn_key = 0;    // Zobrist key of the pawns alone
+    uint64_t m_material_key = 0;
+    std::optional<nnue::Accumulator> m_accumulator;    // only while evaluating with a network
+
     mutable uint64_t m_opposite_attacks, m_current_attacks, m_allowed_moves, m_new_allowed_moves;
     mutable MoveList m_move_list;
 
+    // Attack maps of each colour, white's first, left by move generation for the evaluation
+    mutable std::array<AttackMaps, 2> m_attack_maps = {};
+    mutable bool m_attack_maps_valid = false;
+
     uint8_t m_white_to_move; // 1 or 0
     uint8_t m_castling_rights = 0;
 
@@ -87,6 +102,17 @@ private:
         std::make_pair(&m_kings, PieceType::KING)
     };
 
+    PieceType piece_type_at(uint64_t mask) const;
+
+    void set_attack_maps(bool white, uint64_t knights, uint64_t bishops, uint64_t rooks, uint64_t queens) const;
+
+    // Squares attacked by the given knights, bishops, rooks or queens, ignoring pins
+    uint64_t piece_attacks(PieceType type, uint64_t pieces) const;
+
+    void add_eval_terms(PieceType type, bool white, uint8_t sq, int sign);
+    void update_eval_terms(const Move& move, PieceType moved, std::optional<PieceType> captured, bool en_passant,
+                           bool white, int sign);
+
 public:
     constexpr inline uint64_t get_occupied() const { return m_occupied; }
     constexpr inline uint64_t get_rooks() const { return m_rooks; }
@@ -109,6 +135,7 @@ public:
 public:
     BitBoard();
     BitBoard(const BitBoard& orig);
+    BitBoard& operator=(const BitBoard& orig);
 
     //! Set the board to the starting position
     /*!
@@ -158,4 +185,56 @@ public:
 
     bool make_move(const Move& move);
     bool unmake_move(const Move& move);
+
+    //! Material and piece-square table values of white's pieces less black's, kings included
+    Score get_psq_score() const { return m_psq; }
+
+    //! Zobrist key of the pawns of both colours, and nothing else, e.g. for caching pawn structure
+    uint64_t get_pawn_key() const { return m_pawn_key; }
+
+    //! Number of pieces of each type and colour, laid out as described in material_table.h
+    uint64_t get_material_key() const { return m_material_key; }
+
+    //! Keep a neural network's accumulator up to date from now on, or stop with nullptr
+    void set_network(std::shared_ptr<const nnue::Network> network);
+
+    //! Accumulator of the network set with set_network(), if any
+    const nnue::Accumulator* get_accumulator() const { return m_accumulator ? &*m_accumulator : nullptr; }
+
+    //! Recompute the running evaluation totals from the pieces on the board
+    /*!
+     * They are kept up to date by add_piece(), make_move() and unmake_move(), so this is only
+     * needed to check them.
+     */
+    void refresh_eval_terms();
+
+    //! Squares attacked by a colour's pieces, by piece type
+    /*!
+     * Move generation leaves these behind, so after get_all_legal_moves() they cost nothing until
+     * the pieces move again; otherwise they are worked out here. Either way pins are ignored: a
+     * pinned piece attacks every square it would if it could move. Pawn maps hold captures only.
+     */
+    const AttackMaps& get_attack_maps(bool white) const;
+
+    //! Pieces of either colour attacking a square
+    /*!
+     * \param occupied occupancy to use for sliding pieces, e.g. with pieces removed to reveal x-rays
+     */
+    uint64_t attackers_to(uint8_t sq, uint64_t occupied) const;
+
+    //! Whether a move would check the opponent's king, directly or by discovery
+    /*!
+     * Checks given by the rook when castling and discovered by en passant captures are not detected.
+     */
+    bool gives_check(const Move& move) const;
+
+    //! Static exchange evaluation of a move, in centipawns
+    /*!
+     * Material the moving side wins if both sides keep recapturing on the target square with their
+     * least valuable attacker, each stopping when recapturing would lose. Pins are ignored.
+     */
+    int see(const Move& move) const;
+
+    //! Whether the static exchange evaluation of a move is at least threshold centipawns
+    bool see_ge(const Move& move, int threshold) const { return see(move) >= threshold; }
 };
\ No newline at end of file
@@ -200,6 +200,39 @@ static constexpr uint64_t get_ray_attacks(uint8_t sq, BitBoardRayState& state)
 }
 
 
+// Plain sliding attacks along one ray, without the pin and check bookkeeping of move generation
+template<RayDir Dir>
+static constexpr uint64_t get_sliding_attacks(uint8_t sq, uint64_t occupied)
+{
+    constexpr bool positive = Dir == RayDir::NE || Dir == RayDir::N || Dir == RayDir::NW || Dir == RayDir::E;
+
+    uint64_t blocked_ray = occupied & get_ray_mask<Dir>(sq);
+    if (!blocked_ray)
+        return get_ray_mask<Dir>(sq);
+
+    uint8_t blocker = positive ? bit_scan_forward(blocked_ray) : bit_scan_reverse(blocked_ray);
+    return get_ray_mask<Dir>(sq) ^ get_ray_mask<Dir>(blocker);
+}
+
+
+uint64_t bishop_attacks(uint8_t sq, uint64_t occupied)
+{
+    return get_sliding_attacks<RayDir::NE>(sq, occupied) |
+           get_sliding_attacks<RayDir::SE>(sq, occupied) |
+           get_sliding_attacks<RayDir::NW>(sq, occupied) |
+           get_sliding_attacks<RayDir::SW>(sq, occupied);
+}
+
+
+uint64_t rook_attacks(uint8_t sq, uint64_t occupied)
+{
+    return get_sliding_attacks<RayDir::N>(sq, occupied) |
+           get_sliding_attacks<RayDir::S>(sq, occupied) |
+           get_sliding_attacks<RayDir::E>(sq, occupied) |
+           get_sliding_attacks<RayDir::W>(sq, occupied);
+}
+
+
 template<bool WhiteToMove>
 uint64_t BitboardRayAttacks<WhiteToMove>::get_pinned_piece_moves(BitBoard::MoveList& move_list, uint64_t& pieces, std::function<uint64_t(uint8_t)> attacks_fn) const
 {
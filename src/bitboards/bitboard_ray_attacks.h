@@ -27,6 +27,13 @@ struct BitBoardRayState
 };
 
 
+//! Squares a bishop on sq attacks, up to and including the first occupied square in each direction
+uint64_t bishop_attacks(uint8_t sq, uint64_t occupied);
+
+//! Squares a rook on sq attacks, up to and including the first occupied square in each direction
+uint64_t rook_attacks(uint8_t sq, uint64_t occupied);
+
+
 template<bool WhiteToMove>
 class BitboardRayAttacks
 {
@@ -0,0 +1,11 @@
+#pragma once
+
+// Marks a hot loop to be compiled twice, for AVX2 and for the baseline x86-64 the rest of the
+// program targets, with the version to run picked once at load time from what the CPU supports.
+// Builds that already target AVX2 (JOHNCHESS_AVX2 in CMake), and compilers or platforms without
+// function multiversioning, get the one version as before.
+#if !defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && defined(__ELF__)
+#define AVX2_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define AVX2_CLONES
+#endif
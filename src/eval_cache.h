@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "hash_stats.h"
+
+// Static evaluations by position hash, so a position reached again through a transposition or a
+// later iteration isn't evaluated again. Each search thread has its own cache, so it needs no
+// locking. To keep entries small, only the upper half of the hash is checked, which is still far
+// more than the bits choosing the slot.
+class EvalCache
+{
+private:
+    struct Entry {
+        uint32_t check = 0;
+        float score = 0.f;
+    };
+
+    static constexpr size_t ENTRIES = 1 << 16;
+
+    std::vector<Entry> m_entries;
+    HashStats m_stats;
+
+    static uint32_t check(uint64_t hash) { return static_cast<uint32_t>(hash >> 32); }
+
+public:
+    EvalCache() : m_entries(ENTRIES) {}
+
+    //! Evaluation stored for a position, for the side to move
+    /*!
+     * \return whether there was one
+     */
+    bool probe(uint64_t hash, float& score)
+    {
+        const Entry& e = m_entries[hash & (ENTRIES - 1)];
+
+        ++m_stats.probes;
+        if (e.check != check(hash))
+            return false;
+
+        ++m_stats.hits;
+        score = e.score;
+        return true;
+    }
+
+    void store(uint64_t hash, float score) { m_entries[hash & (ENTRIES - 1)] = { check(hash), score }; }
+
+    void clear() { std::fill(m_entries.begin(), m_entries.end(), Entry()); }
+
+    const HashStats& stats() const { return m_stats; }
+    void reset_stats() { m_stats = {}; }
+};
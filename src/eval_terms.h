@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#include "score.h"
+
+// Weights and bitboard helpers of the handwritten evaluation, shared by ShannonHeuristic and the
+// batch evaluator so the two always score a position the same. Arrays indexed by piece are in
+// PieceType order (king, queen, rook, bishop, knight, pawn).
+namespace eval_terms
+{
+
+inline constexpr uint64_t FILE_A = 0x0101010101010101ULL;
+inline constexpr uint64_t FILE_H = 0x8080808080808080ULL;
+
+// Bonus by advancement rank (0=start, 6=one step from promotion), half as much again in the endgame.
+inline constexpr Score PASSED_PAWN_BONUS[8] = {
+    S(0, 0), S(10, 15), S(15, 23), S(20, 30), S(30, 45), S(45, 68), S(70, 105), S(0, 0)
+};
+
+inline constexpr Score ROOK_OPEN_FILE      = S(25, 25);
+inline constexpr Score ROOK_SEMI_OPEN_FILE = S(10, 10);
+inline constexpr Score BISHOP_PAIR         = S(50, 50);
+
+// Each doubled, blocked or isolated pawn
+inline constexpr Score PAWN_WEAKNESS = S(-50, -50);
+
+// Each square a piece type attacks outside its own pieces and the enemy pawns' reach
+inline constexpr Score MOBILITY[6] = {
+    S(0, 0), S(1, 2), S(2, 4), S(5, 5), S(4, 4), S(0, 0)
+};
+
+// Each square next to the king attacked by an enemy piece type. Only the middlegame value counts,
+// as the king joins in once the heavy pieces are off.
+inline constexpr Score KING_ZONE_ATTACK[6] = {
+    S(0, 0), S(-12, 0), S(-8, 0), S(-6, 0), S(-6, 0), S(0, 0)
+};
+
+constexpr uint64_t north_fill(uint64_t bb) {
+    bb |= bb << 8; bb |= bb << 16; bb |= bb << 32; return bb;
+}
+constexpr uint64_t south_fill(uint64_t bb) {
+    bb |= bb >> 8; bb |= bb >> 16; bb |= bb >> 32; return bb;
+}
+
+//! Squares strictly ahead of the pawns, towards promotion, on their own and adjacent files
+constexpr uint64_t front_spans(uint64_t pawns, bool white)
+{
+    uint64_t ahead = white ? north_fill(pawns << 8) : south_fill(pawns >> 8);
+    return ahead | ((ahead & ~FILE_A) >> 1) | ((ahead & ~FILE_H) << 1);
+}
+
+//! Whole files holding any of the given pieces
+constexpr uint64_t file_fill(uint64_t bb)
+{
+    return north_fill(south_fill(bb));
+}
+
+//! Squares the pawns capture on
+constexpr uint64_t pawn_attacks(uint64_t pawns, bool white)
+{
+    return white ? ((pawns << 7) & ~FILE_H) | ((pawns << 9) & ~FILE_A)
+                 : ((pawns >> 9) & ~FILE_H) | ((pawns >> 7) & ~FILE_A);
+}
+
+}
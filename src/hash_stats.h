@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Lookups in one of the evaluation caches and how many of them found their entry
+struct HashStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+    //! Percentage of probes that hit, 0 if there were none
+    double hit_rate() const { return probes ? 100.0 * hits / probes : 0.0; }
+
+    HashStats& operator+=(const HashStats& other)
+    {
+        probes += other.probes;
+        hits += other.hits;
+        return *this;
+    }
+};
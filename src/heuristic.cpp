@@ -1,209 +1,40 @@
 #include "heuristic.h"
 
 #include <bitboards/bitboard_utils.h>
+#include <eval_terms.h>
+#include <piece_square_tables.h>
 
-using namespace bitboard_utils;
-
-static constexpr uint64_t FILE_A = 0x0101010101010101ULL;
-static constexpr uint64_t FILE_H = 0x8080808080808080ULL;
-
-static constexpr uint64_t north_fill(uint64_t bb) {
-    bb |= bb << 8; bb |= bb << 16; bb |= bb << 32; return bb;
-}
-static constexpr uint64_t south_fill(uint64_t bb) {
-    bb |= bb >> 8; bb |= bb >> 16; bb |= bb >> 32; return bb;
-}
+#include <algorithm>
 
-// Bonus by advancement rank (0=start, 6=one step from promotion).
-static constexpr float passed_pawn_bonus[8] = {
-    0.00f, 0.10f, 0.15f, 0.20f, 0.30f, 0.45f, 0.70f, 0.00f
-};
+using namespace bitboard_utils;
+using namespace eval_terms;
 
-static float score_passed_pawns(uint64_t our_pawns, uint64_t their_pawns, bool we_are_white)
+// Pawns with no enemy pawn ahead of them on their own or an adjacent file, i.e. not in any enemy
+// pawn's front spans
+static uint64_t find_passed_pawns(uint64_t our_pawns, uint64_t their_pawns, bool we_are_white)
 {
-    float score = 0.0f;
-    uint64_t pawns = our_pawns;
-    while (pawns) {
-        uint8_t sq = bit_scan_forward(pawns);
-        pawns &= pawns - 1;
-        uint64_t bit = 1ULL << sq;
-        // All squares strictly ahead on the same and adjacent files.
-        uint64_t ahead = we_are_white ? north_fill(bit << 8) : south_fill(bit >> 8);
-        uint64_t mask  = ahead | ((ahead & ~FILE_A) >> 1) | ((ahead & ~FILE_H) << 1);
-        if (!(their_pawns & mask)) {
-            int rank        = sq >> 3;
-            int advancement = we_are_white ? rank : (7 - rank);
-            score += passed_pawn_bonus[advancement];
-        }
-    }
-    return score;
+    return our_pawns & ~front_spans(their_pawns, !we_are_white);
 }
 
-static float score_rooks_on_files(uint64_t our_rooks, uint64_t our_pawns, uint64_t all_pawns)
+static Score score_passed_pawns(uint64_t passed, bool we_are_white)
 {
-    float score = 0.0f;
-    uint64_t rooks = our_rooks;
-    while (rooks) {
-        uint8_t sq = bit_scan_forward(rooks);
-        rooks &= rooks - 1;
-        uint64_t file_mask = FILE_A << (sq & 7);
-        if (!(all_pawns & file_mask))
-            score += 0.25f;  // open file
-        else if (!(our_pawns & file_mask))
-            score += 0.10f;  // semi-open file
+    Score score = 0;
+    while (passed) {
+        uint8_t sq = bit_scan_forward(passed);
+        passed &= passed - 1;
+        int rank        = sq >> 3;
+        int advancement = we_are_white ? rank : (7 - rank);
+        score += PASSED_PAWN_BONUS[advancement];
     }
     return score;
 }
 
-// PSTs defined from White's perspective, index 0=a1 through 63=h8.
-// Rows written rank-8 first for visual readability.
-
-// clang-format off
-static constexpr float pawn_pst[64] = {
-    // rank 1
-     0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,
-    // rank 2
-    -0.05f, -0.05f, -0.05f,  0.00f,  0.00f, -0.05f, -0.05f, -0.05f,
-    // rank 3
-     0.05f, -0.05f, -0.10f,  0.00f,  0.00f, -0.10f, -0.05f,  0.05f,
-    // rank 4
-     0.00f,  0.00f,  0.00f,  0.20f,  0.20f,  0.00f,  0.00f,  0.00f,
-    // rank 5
-     0.05f,  0.05f,  0.10f,  0.25f,  0.25f,  0.10f,  0.05f,  0.05f,
-    // rank 6
-     0.10f,  0.10f,  0.20f,  0.30f,  0.30f,  0.20f,  0.10f,  0.10f,
-    // rank 7 (one step from promotion)
-     0.50f,  0.60f,  0.60f,  0.70f,  0.70f,  0.60f,  0.60f,  0.50f,
-    // rank 8
-     0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,
-};
-
-static constexpr float knight_pst[64] = {
-    // rank 1
-    -0.50f, -0.40f, -0.30f, -0.30f, -0.30f, -0.30f, -0.40f, -0.50f,
-    // rank 2
-    -0.40f, -0.20f,  0.00f,  0.05f,  0.05f,  0.00f, -0.20f, -0.40f,
-    // rank 3
-    -0.30f,  0.05f,  0.10f,  0.15f,  0.15f,  0.10f,  0.05f, -0.30f,
-    // rank 4
-    -0.30f,  0.00f,  0.15f,  0.20f,  0.20f,  0.15f,  0.00f, -0.30f,
-    // rank 5
-    -0.30f,  0.05f,  0.15f,  0.20f,  0.20f,  0.15f,  0.05f, -0.30f,
-    // rank 6
-    -0.30f,  0.00f,  0.10f,  0.15f,  0.15f,  0.10f,  0.00f, -0.30f,
-    // rank 7
-    -0.40f, -0.20f,  0.00f,  0.00f,  0.00f,  0.00f, -0.20f, -0.40f,
-    // rank 8
-    -0.50f, -0.40f, -0.30f, -0.30f, -0.30f, -0.30f, -0.40f, -0.50f,
-};
-
-static constexpr float bishop_pst[64] = {
-    // rank 1
-    -0.20f, -0.10f, -0.10f, -0.10f, -0.10f, -0.10f, -0.10f, -0.20f,
-    // rank 2
-    -0.10f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f, -0.10f,
-    // rank 3
-    -0.10f,  0.00f,  0.05f,  0.10f,  0.10f,  0.05f,  0.00f, -0.10f,
-    // rank 4
-    -0.10f,  0.05f,  0.05f,  0.10f,  0.10f,  0.05f,  0.05f, -0.10f,
-    // rank 5
-    -0.10f,  0.00f,  0.10f,  0.10f,  0.10f,  0.10f,  0.00f, -0.10f,
-    // rank 6
-    -0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f, -0.10f,
-    // rank 7
-    -0.10f,  0.05f,  0.00f,  0.00f,  0.00f,  0.00f,  0.05f, -0.10f,
-    // rank 8
-    -0.20f, -0.10f, -0.10f, -0.10f, -0.10f, -0.10f, -0.10f, -0.20f,
-};
-
-static constexpr float rook_pst[64] = {
-    // rank 1
-     0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,
-    // rank 2
-    -0.05f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f, -0.05f,
-    // rank 3
-    -0.05f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f, -0.05f,
-    // rank 4
-     0.00f,  0.00f,  0.00f,  0.05f,  0.05f,  0.00f,  0.00f,  0.00f,
-    // rank 5
-     0.05f,  0.05f,  0.05f,  0.05f,  0.05f,  0.05f,  0.05f,  0.05f,
-    // rank 6
-     0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,
-    // rank 7 (dominant on 7th rank)
-     0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,  0.10f,
-    // rank 8
-     0.00f,  0.00f,  0.05f,  0.05f,  0.05f,  0.05f,  0.00f,  0.00f,
-};
-
-static constexpr float queen_pst[64] = {
-    // rank 1
-    -0.20f, -0.10f, -0.10f, -0.05f, -0.05f, -0.10f, -0.10f, -0.20f,
-    // rank 2
-    -0.10f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f,  0.00f, -0.10f,
-    // rank 3
-    -0.10f,  0.00f,  0.05f,  0.05f,  0.05f,  0.05f,  0.00f, -0.10f,
-    // rank 4
-    -0.05f,  0.00f,  0.05f,  0.05f,  0.05f,  0.05f,  0.00f, -0.05f,
-    // rank 5
-     0.00f,  0.00f,  0.05f,  0.05f,  0.05f,  0.05f,  0.00f, -0.05f,
-    // rank 6
-    -0.10f,  0.05f,  0.05f,  0.05f,  0.05f,  0.05f,  0.00f, -0.10f,
-    // rank 7
-    -0.10f,  0.00f,  0.05f,  0.00f,  0.00f,  0.00f,  0.00f, -0.10f,
-    // rank 8
-    -0.20f, -0.10f, -0.10f, -0.05f, -0.05f, -0.10f, -0.10f, -0.20f,
-};
-
-// Middlegame: reward castled position, penalise centre exposure.
-static constexpr float king_mg_pst[64] = {
-    // rank 1
-     0.20f,  0.30f,  0.10f,  0.00f,  0.00f,  0.10f,  0.30f,  0.20f,
-    // rank 2
-     0.20f,  0.20f,  0.00f,  0.00f,  0.00f,  0.00f,  0.20f,  0.20f,
-    // rank 3
-    -0.10f, -0.20f, -0.20f, -0.20f, -0.20f, -0.20f, -0.20f, -0.10f,
-    // rank 4
-    -0.20f, -0.30f, -0.30f, -0.40f, -0.40f, -0.30f, -0.30f, -0.20f,
-    // rank 5
-    -0.30f, -0.40f, -0.40f, -0.50f, -0.50f, -0.40f, -0.40f, -0.30f,
-    // rank 6
-    -0.30f, -0.40f, -0.40f, -0.50f, -0.50f, -0.40f, -0.40f, -0.30f,
-    // rank 7
-    -0.30f, -0.40f, -0.40f, -0.50f, -0.50f, -0.40f, -0.40f, -0.30f,
-    // rank 8
-    -0.30f, -0.40f, -0.40f, -0.50f, -0.50f, -0.40f, -0.40f, -0.30f,
-};
-
-// Endgame: king should centralise and become active.
-static constexpr float king_eg_pst[64] = {
-    // rank 1
-    -0.50f, -0.30f, -0.30f, -0.30f, -0.30f, -0.30f, -0.30f, -0.50f,
-    // rank 2
-    -0.30f, -0.30f,  0.00f,  0.00f,  0.00f,  0.00f, -0.30f, -0.30f,
-    // rank 3
-    -0.30f, -0.10f,  0.20f,  0.30f,  0.30f,  0.20f, -0.10f, -0.30f,
-    // rank 4
-    -0.30f, -0.10f,  0.30f,  0.40f,  0.40f,  0.30f, -0.10f, -0.30f,
-    // rank 5
-    -0.30f, -0.10f,  0.30f,  0.40f,  0.40f,  0.30f, -0.10f, -0.30f,
-    // rank 6
-    -0.30f, -0.10f,  0.20f,  0.30f,  0.30f,  0.20f, -0.10f, -0.30f,
-    // rank 7
-    -0.30f, -0.20f, -0.10f,  0.00f,  0.00f, -0.10f, -0.20f, -0.30f,
-    // rank 8
-    -0.50f, -0.40f, -0.30f, -0.20f, -0.20f, -0.30f, -0.40f, -0.50f,
-};
-// clang-format on
-
-static float pst_score(uint64_t pieces, const float* pst, bool mirror)
+static Score score_rooks_on_files(uint64_t our_rooks, uint64_t our_pawns, uint64_t all_pawns)
 {
-    float score = 0;
-    while (pieces) {
-        uint8_t sq = bit_scan_forward(pieces);
-        pieces &= pieces - 1;
-        score += pst[mirror ? (sq ^ 56) : sq];
-    }
-    return score;
+    uint64_t open      = ~file_fill(all_pawns);
+    uint64_t semi_open = ~file_fill(our_pawns) & ~open;
+    return ROOK_OPEN_FILE * static_cast<int>(pop_count(our_rooks & open))
+         + ROOK_SEMI_OPEN_FILE * static_cast<int>(pop_count(our_rooks & semi_open));
 }
 
 static int count_doubled_pawns(uint64_t pawns)
@@ -225,94 +56,132 @@ static int count_blocked_pawns(uint64_t pawns, uint64_t occupied, bool pawns_are
 
 static int count_isolated_pawns(uint64_t pawns)
 {
-    uint64_t fill = pawns;
-    fill |= fill << 8;  fill |= fill >> 8;
-    fill |= fill << 16; fill |= fill >> 16;
-    fill |= fill << 32; fill |= fill >> 32;
-
+    uint64_t fill = file_fill(pawns);
     uint64_t adj_files = ((fill & ~FILE_A) >> 1) | ((fill & ~FILE_H) << 1);
     return pop_count(pawns & ~adj_files);
 }
 
-ShannonHeuristic::ShannonHeuristic(const BitBoard& board, PieceColour ai_colour)
+// Mobility of a side's pieces and the attacks on its king's surroundings, from the attack maps
+static Score score_activity(const BitBoard::AttackMaps& ours, const BitBoard::AttackMaps& theirs,
+                            uint64_t our_pieces)
 {
-    bool ai_is_white = (ai_colour == PieceColour::WHITE);
-
-    uint64_t ai_pieces  = board.pieces_to_move(ai_is_white);
-    uint64_t opp_pieces = board.pieces_to_move(!ai_is_white);
-
-    // Phase detection: interpolate king tables based on remaining non-pawn material.
-    // Full material weight = 2Q + 4R + 4B + 4N = 62.
-    static constexpr float full_material = 62.0f;
-    float remaining = 9.0f * pop_count(board.get_queens())
-                    + 5.0f * pop_count(board.get_rooks())
-                    + 3.0f * pop_count(board.get_bishops())
-                    + 3.0f * pop_count(board.get_knights());
-    float phase = std::min(remaining / full_material, 1.0f);
-
-    // Material + PST for each piece type.
-    uint64_t ai_pawns    = board.get_pawns()   & ai_pieces;
-    uint64_t opp_pawns   = board.get_pawns()   & opp_pieces;
-    uint64_t ai_knights  = board.get_knights() & ai_pieces;
-    uint64_t opp_knights = board.get_knights() & opp_pieces;
-    uint64_t ai_bishops  = board.get_bishops() & ai_pieces;
-    uint64_t opp_bishops = board.get_bishops() & opp_pieces;
-    uint64_t ai_rooks    = board.get_rooks()   & ai_pieces;
-    uint64_t opp_rooks   = board.get_rooks()   & opp_pieces;
-    uint64_t ai_queens   = board.get_queens()  & ai_pieces;
-    uint64_t opp_queens  = board.get_queens()  & opp_pieces;
-    uint64_t ai_king     = board.get_kings()   & ai_pieces;
-    uint64_t opp_king    = board.get_kings()   & opp_pieces;
+    const uint64_t area = ~our_pieces & ~theirs[static_cast<int>(PieceType::PAWN)];
+    const uint64_t king_zone = ours[static_cast<int>(PieceType::KING)];
+
+    Score score = 0;
+    for (PieceType type : { PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN })
+    {
+        const int t = static_cast<int>(type);
+        score += MOBILITY[t] * static_cast<int>(pop_count(ours[t] & area));
+        score += KING_ZONE_ATTACK[t] * static_cast<int>(pop_count(theirs[t] & king_zone));
+    }
+    return score;
+}
 
-    accum += 1.0f * pop_count(ai_pawns)    - 1.0f * pop_count(opp_pawns);
-    accum += 3.0f * pop_count(ai_knights)  - 3.0f * pop_count(opp_knights);
-    accum += 3.0f * pop_count(ai_bishops)  - 3.0f * pop_count(opp_bishops);
-    accum += 5.0f * pop_count(ai_rooks)    - 5.0f * pop_count(opp_rooks);
-    accum += 9.0f * pop_count(ai_queens)   - 9.0f * pop_count(opp_queens);
-    accum += ai_king ? 200.0f : 0.0f;
-    accum -= opp_king ? 200.0f : 0.0f;
+// Fill in the terms that depend on the pawns alone
+static void evaluate_pawns(uint64_t white_pawns, uint64_t black_pawns, PawnEntry& entry)
+{
+    entry.passed[0] = find_passed_pawns(white_pawns, black_pawns, true);
+    entry.passed[1] = find_passed_pawns(black_pawns, white_pawns, false);
 
-    // Bishop pair bonus.
-    if (pop_count(ai_bishops)  >= 2) accum += 0.5f;
-    if (pop_count(opp_bishops) >= 2) accum -= 0.5f;
+    int doubled  = count_doubled_pawns(white_pawns) - count_doubled_pawns(black_pawns);
+    int isolated = count_isolated_pawns(white_pawns) - count_isolated_pawns(black_pawns);
 
-    // PST contributions.
-    accum += pst_score(ai_pawns,    pawn_pst,   !ai_is_white);
-    accum -= pst_score(opp_pawns,   pawn_pst,    ai_is_white);
-    accum += pst_score(ai_knights,  knight_pst, !ai_is_white);
-    accum -= pst_score(opp_knights, knight_pst,  ai_is_white);
-    accum += pst_score(ai_bishops,  bishop_pst, !ai_is_white);
-    accum -= pst_score(opp_bishops, bishop_pst,  ai_is_white);
-    accum += pst_score(ai_rooks,    rook_pst,   !ai_is_white);
-    accum -= pst_score(opp_rooks,   rook_pst,    ai_is_white);
-    accum += pst_score(ai_queens,   queen_pst,  !ai_is_white);
-    accum -= pst_score(opp_queens,  queen_pst,   ai_is_white);
+    entry.score = PAWN_WEAKNESS * (doubled + isolated)
+                + score_passed_pawns(entry.passed[0], true)
+                - score_passed_pawns(entry.passed[1], false);
+}
 
-    // King safety: interpolate between middlegame and endgame tables.
-    auto king_pst_score = [&](uint64_t king, bool mirror) {
-        float mg = pst_score(king, king_mg_pst, mirror);
-        float eg = pst_score(king, king_eg_pst, mirror);
-        return phase * mg + (1.0f - phase) * eg;
+// Fill in the terms that depend on the material alone
+static void evaluate_material(uint64_t key, MaterialEntry& entry)
+{
+    using namespace piece_square_tables;
+
+    auto count = [&](PieceType type, bool white) { return material_key::count(key, type, white); };
+
+    int phase = 0;
+    for (PieceType type : { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT })
+        phase += PHASE_WEIGHT[static_cast<int>(type)] * (count(type, true) + count(type, false));
+    entry.phase = static_cast<uint8_t>(std::min(phase, FULL_PHASE));
+
+    entry.imbalance = 0;
+    if (count(PieceType::BISHOP, true) >= 2) entry.imbalance += BISHOP_PAIR;
+    if (count(PieceType::BISHOP, false) >= 2) entry.imbalance -= BISHOP_PAIR;
+
+    // Without pawns, a side needs more than a minor piece or two knights to force mate.
+    auto cannot_mate = [&](bool white) {
+        if (count(PieceType::QUEEN, white) || count(PieceType::ROOK, white))
+            return false;
+        int bishops = count(PieceType::BISHOP, white);
+        int knights = count(PieceType::KNIGHT, white);
+        return bishops + knights <= 1 || (bishops == 0 && knights == 2);
     };
-    accum += king_pst_score(ai_king,  !ai_is_white);
-    accum -= king_pst_score(opp_king,  ai_is_white);
+    entry.draw = !count(PieceType::PAWN, true) && !count(PieceType::PAWN, false) && cannot_mate(true)
+              && cannot_mate(false);
+}
+
+ShannonHeuristic::ShannonHeuristic(const BitBoard& board, PieceColour ai_colour, float alpha, float beta,
+                                   EvalTables* tables)
+{
+    using namespace piece_square_tables;
+
+    // Phase, bishop pairs and drawn endings come from the material table when there is one.
+    MaterialEntry local_material;
+    bool found = false;
+    MaterialEntry& material = tables ? tables->material.probe(board.get_material_key(), found) : local_material;
+    if (!found)
+        evaluate_material(board.get_material_key(), material);
+    if (material.draw)
+        return;
+
+    // Everything is scored from White's side, and negated at the end if we are Black.
+    uint64_t white_pieces = board.pieces_to_move(true);
+    uint64_t black_pieces = board.pieces_to_move(false);
+
+    // Material and PSTs are kept up to date by the board as pieces move.
+    Score score = board.get_psq_score() + material.imbalance;
+
+    uint64_t white_pawns   = board.get_pawns()   & white_pieces;
+    uint64_t black_pawns   = board.get_pawns()   & black_pieces;
+    uint64_t white_rooks   = board.get_rooks()   & white_pieces;
+    uint64_t black_rooks   = board.get_rooks()   & black_pieces;
+
+    // Doubled, isolated and passed pawns come from the pawn hash table when there is one.
+    PawnEntry local_pawns;
+    PawnEntry& pawns = tables ? tables->pawns.probe(board.get_pawn_key(), found) : local_pawns;
+    if (!found)
+        evaluate_pawns(white_pawns, black_pawns, pawns);
+    score += pawns.score;
+
+    // Blocked pawns depend on the other pieces too.
+    int white_S = count_blocked_pawns(white_pawns, board.get_occupied(), true);
+    int black_S = count_blocked_pawns(black_pawns, board.get_occupied(), false);
+    score += PAWN_WEAKNESS * (white_S - black_S);
+
+    // Pawn structure can be worth several pawns but is cheap once hashed, so it is counted before
+    // deciding. The remaining terms can't move a score this far outside the window back into it,
+    // so the partial score less the margin is a bound on the full one.
+    const int sign = ai_colour == PieceColour::WHITE ? 1 : -1;
+    const int partial = sign * taper(score, material.phase, FULL_PHASE);
+    if (partial - LAZY_MARGIN >= beta * 100 || partial + LAZY_MARGIN <= alpha * 100)
+    {
+        accum = (partial - LAZY_MARGIN >= beta * 100 ? partial - LAZY_MARGIN : partial + LAZY_MARGIN) / 100.0f;
+        lazy = true;
+        return;
+    }
 
-    // Pawn structure penalties.
-    int ai_D  = count_doubled_pawns(ai_pawns);
-    int opp_D = count_doubled_pawns(opp_pawns);
-    int ai_S  = count_blocked_pawns(ai_pawns,  board.get_occupied(),  ai_is_white);
-    int opp_S = count_blocked_pawns(opp_pawns, board.get_occupied(), !ai_is_white);
-    int ai_I  = count_isolated_pawns(ai_pawns);
-    int opp_I = count_isolated_pawns(opp_pawns);
+    // Rooks on open and semi-open files.
+    score += score_rooks_on_files(white_rooks, white_pawns, board.get_pawns());
+    score -= score_rooks_on_files(black_rooks, black_pawns, board.get_pawns());
 
-    accum -= 0.5f * ((ai_D - opp_D) + (ai_S - opp_S) + (ai_I - opp_I));
+    // Mobility and king safety, from the attack maps move generation has usually just made.
+    const BitBoard::AttackMaps& white_attacks = board.get_attack_maps(true);
+    const BitBoard::AttackMaps& black_attacks = board.get_attack_maps(false);
+    score += score_activity(white_attacks, black_attacks, white_pieces);
+    score -= score_activity(black_attacks, white_attacks, black_pieces);
 
-    // Passed pawns: bonus scales with advancement rank, slightly amplified in the endgame.
-    float passed_scale = 1.0f + 0.5f * (1.0f - phase);
-    accum += passed_scale * score_passed_pawns(ai_pawns,  opp_pawns, ai_is_white);
-    accum -= passed_scale * score_passed_pawns(opp_pawns, ai_pawns, !ai_is_white);
+    // Blend the middlegame and endgame values by the non-pawn material left.
+    int centipawns = taper(score, material.phase, FULL_PHASE);
 
-    // Rooks on open and semi-open files.
-    accum += score_rooks_on_files(ai_rooks,  ai_pawns,  board.get_pawns());
-    accum -= score_rooks_on_files(opp_rooks, opp_pawns, board.get_pawns());
+    accum = sign * centipawns / 100.0f;
 }
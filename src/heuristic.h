@@ -1,6 +1,32 @@
 #pragma once
 
 #include "bitboards/bitboard.h"
+#include "material_table.h"
+#include "pawn_hash_table.h"
+
+#include <limits>
+
+// Caches of evaluation terms that depend on only part of the position, one set per search thread
+struct EvalTables {
+    PawnHashTable pawns;
+    MaterialTable material;
+};
+
+// How many evaluations were made and how many of them stopped early, outside their window
+struct EvalStats {
+    uint64_t calls = 0;
+    uint64_t lazy_exits = 0;
+
+    //! Percentage of calls that stopped early, 0 if there were none
+    double lazy_rate() const { return calls ? 100.0 * lazy_exits / calls : 0.0; }
+
+    EvalStats& operator+=(const EvalStats& other)
+    {
+        calls += other.calls;
+        lazy_exits += other.lazy_exits;
+        return *this;
+    }
+};
 
 class ShannonHeuristic
 {
@@ -14,13 +40,40 @@ class ShannonHeuristic
 
 // KQRBNP = number of kings, queens, rooks, bishops, knights and pawns
 // D,S,I = doubled, blocked and isolated pawns
-// M = Mobility (the number of legal moves)
+// M = Mobility (squares attacked by each piece type, outside own pieces and enemy pawn attacks)
+// Attacks on the squares around each king count against that side too.
 private:
     float accum = 0.0;
+    bool lazy = false;
 
 public:
-    ShannonHeuristic(const BitBoard& board, PieceColour colour);
-    
+    //! Largest change, in centipawns, the rook file, mobility and king safety terms are assumed to
+    //! make. Random games reach about 300.
+    static constexpr int LAZY_MARGIN = 400;
+
+    //! Evaluate a position
+    /*!
+     * \param tables caches for the pawn structure and material terms, or nullptr to compute them
+     */
+    ShannonHeuristic(const BitBoard& board, PieceColour colour, EvalTables* tables = nullptr) :
+        ShannonHeuristic(board, colour, -std::numeric_limits<float>::infinity(),
+                         std::numeric_limits<float>::infinity(), tables)
+    {}
+
+    //! Evaluate a position only as far as needed to place it against a window
+    /*!
+     * If material, piece-square tables and pawn structure are further than LAZY_MARGIN outside
+     * (alpha, beta), the other terms are skipped. The score is then a bound, pulled back towards
+     * the window by the margin: at least beta, or at most alpha.
+     *
+     * \param alpha, beta window in pawns, from colour's point of view
+     */
+    ShannonHeuristic(const BitBoard& board, PieceColour colour, float alpha, float beta,
+                     EvalTables* tables = nullptr);
+
     float get() const { return accum; };
+
+    //! Whether the evaluation stopped early, so the score is only a bound
+    bool is_lazy() const { return lazy; }
 };
 
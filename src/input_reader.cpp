@@ -0,0 +1,60 @@
+#include "input_reader.h"
+
+#include <stdexcept>
+#include <thread>
+
+void InputReader::start()
+{
+    if (m_queue)
+        return;
+
+    m_queue = std::make_shared<Queue>();
+
+    std::thread([queue = m_queue, &instr = m_instr] {
+        std::string rcvd;
+        while (std::getline(instr, rcvd))
+        {
+            {
+                std::lock_guard lock(queue->mutex);
+                queue->lines.push_back(rcvd);
+            }
+            queue->cv.notify_one();
+        }
+
+        {
+            std::lock_guard lock(queue->mutex);
+            queue->lines.push_back("quit");
+        }
+        queue->cv.notify_one();
+    }).detach();
+}
+
+std::string InputReader::read_line()
+{
+    if (!m_queue)
+    {
+        std::string rcvd;
+        std::getline(m_instr, rcvd);
+        return rcvd;
+    }
+
+    std::unique_lock lock(m_queue->mutex);
+    m_queue->cv.wait(lock, [&] { return !m_queue->lines.empty(); });
+    std::string rcvd = std::move(m_queue->lines.front());
+    m_queue->lines.pop_front();
+    return rcvd;
+}
+
+std::optional<std::string> InputReader::poll_line(std::chrono::milliseconds timeout)
+{
+    if (!m_queue)
+        throw std::runtime_error("poll_line called before start");
+
+    std::unique_lock lock(m_queue->mutex);
+    if (!m_queue->cv.wait_for(lock, timeout, [&] { return !m_queue->lines.empty(); }))
+        return std::nullopt;
+
+    std::string rcvd = std::move(m_queue->lines.front());
+    m_queue->lines.pop_front();
+    return rcvd;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+// Line-based protocol input. Until start() is called lines are read directly from the stream;
+// afterwards a background thread reads them into a queue, so they can be polled during a search.
+// One reader can be shared by several protocol front-ends.
+class InputReader
+{
+private:
+    // Shared with the reader thread, which is detached because a blocking read can't be
+    // interrupted, so it must outlive this object.
+    struct Queue
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::string> lines;
+    };
+
+    std::istream& m_instr;
+    std::shared_ptr<Queue> m_queue;     // set once the reader thread is running
+
+public:
+    InputReader(std::istream& instr) : m_instr(instr) {}
+
+    //! Read input on a background thread from now on
+    /*!
+     * End of input is reported as a final 'quit' line.
+     */
+    void start();
+
+    bool is_started() const { return m_queue != nullptr; }
+
+    //! Block until a line is available
+    std::string read_line();
+
+    //! Wait up to timeout for a line, returning nothing if none arrived
+    /*!
+     * Only available once start() has been called.
+     */
+    std::optional<std::string> poll_line(std::chrono::milliseconds timeout);
+};
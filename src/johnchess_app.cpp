@@ -1,26 +1,80 @@
 #include "johnchess_app.h"
 #include <stdexcept>
 #include <fstream>
+#include <thread>
+#include <algorithm>
+#include <utility>
 
 #include "bitboards/bitboard.h"
 #include "utils/board_strings.h"
+#include "bench.h"
+#include "batch_eval.h"
 
 JohnchessApp::JohnchessApp(int argc, const char* argv[]) :
+    JohnchessApp(argc, argv, nullptr, nullptr)
+{
+}
+
+JohnchessApp::JohnchessApp(int argc, const char* argv[], std::istream& in, std::ostream& out) :
+    JohnchessApp(argc, argv, &in, &out)
+{
+}
+
+JohnchessApp::JohnchessApp(int argc, const char* argv[], std::istream* in, std::ostream* out) :
     m_app_opts(NULL),
     m_force_mode(false)
 {
     m_app_opts = parse_args(argc, argv);
-    m_xboard_interface = std::make_unique<XBoardInterface>(get_input_stream(), get_output_stream(), "Johnchess v0.1");
+    m_app_opts->in_stream = in;
+    m_app_opts->out_stream = out;
+    m_input = std::make_shared<InputReader>(get_input_stream());
+
+    m_xboard_interface = std::make_unique<XBoardInterface>(m_input, get_output_stream(), "Johnchess v0.1");
     m_xboard_interface->add_feature("memory=1");
     m_xboard_interface->add_feature("setboard=0");
     m_xboard_interface->add_feature("ping=1");
+    m_xboard_interface->add_feature("smp=1");
+    m_xboard_interface->add_feature("analyze=1");
     m_xboard_interface->add_variant("normal");
+    m_xboard_interface->add_option("Parallel search -combo " +
+        std::string(m_app_opts->parallel_mode == ParallelMode::ABDADA ? "Lazy SMP /// *ABDADA" : "*Lazy SMP /// ABDADA"));
+    m_xboard_interface->add_option("MultiPV -spin 1 1 " + std::to_string(MAX_MULTI_PV));
 
-    show_welcome();
     m_board = std::make_unique<BitBoard>();
     m_board->set_to_start_position();
-
-    m_ai = std::make_unique<BasicAI>(PieceColour::BLACK);
+    m_history.reset(m_hasher.get_hash(*m_board));
+
+    unsigned threads = m_app_opts->threads ? m_app_opts->threads : std::thread::hardware_concurrency();
+    m_ai = std::make_unique<BasicAI>(PieceColour::BLACK, threads);
+    m_ai->set_parallel_mode(m_app_opts->parallel_mode);
+    if (!m_app_opts->nnue_file.empty())
+        m_ai->set_network(nnue::load_network(m_app_opts->nnue_file));
+
+    m_uci_interface = std::make_unique<UciInterface>(m_input, get_output_stream(), "Johnchess 0.1", "John Wilson");
+    m_uci_interface->add_option("Hash type spin default " + std::to_string(TranspositionTable::DEFAULT_SIZE_MB) +
+                                " min 1 max " + std::to_string(TranspositionTable::MAX_SIZE_MB));
+    m_uci_interface->add_option("Threads type spin default " + std::to_string(std::max(1u, threads)) + " min 1 max 256");
+    m_uci_interface->add_option("Ponder type check default false");
+    m_uci_interface->add_option("Parallel search type combo default " +
+        std::string(m_app_opts->parallel_mode == ParallelMode::ABDADA ? "ABDADA" : "Lazy SMP") +
+        " var Lazy SMP var ABDADA");
+    m_uci_interface->add_option("MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV));
+
+    for (const auto& option : pruning_options())
+    {
+        if (option.enabled)
+        {
+            m_xboard_interface->add_option(option.name + " -check " + (*option.enabled ? "1" : "0"));
+            m_uci_interface->add_option(option.name + " type check default " + (*option.enabled ? "true" : "false"));
+        }
+        else
+        {
+            m_xboard_interface->add_option(option.name + " -spin " + std::to_string(*option.value) + " " +
+                                           std::to_string(option.min) + " " + std::to_string(option.max));
+            m_uci_interface->add_option(option.name + " type spin default " + std::to_string(*option.value) +
+                                        " min " + std::to_string(option.min) + " max " + std::to_string(option.max));
+        }
+    }
 }
 
 JohnchessApp::~JohnchessApp()
@@ -29,25 +83,102 @@ JohnchessApp::~JohnchessApp()
         delete m_app_opts;
 }
 
-void JohnchessApp::make_ai_move()
+ThinkCallback JohnchessApp::thinking_callback()
+{
+    if (!m_post_mode)
+        return nullptr;
+
+    return [this](uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& principal_variation,
+                  uint8_t) {
+        m_xboard_interface->send_thinking(depth, score_cp, elapsed_cs, nodes, principal_variation,
+                                          mate_in_moves(score_cp));
+    };
+}
+
+std::optional<Move> JohnchessApp::wait_for_search()
+{
+    while (m_ai->is_thinking())
+    {
+        auto rcvd = m_xboard_interface->poll_command(COMMAND_POLL_INTERVAL);
+        if (!rcvd)
+            continue;
+
+        if (rcvd->is_invalid())
+        {
+            m_xboard_interface->reply_invalid(*rcvd);
+            continue;
+        }
+
+        switch (rcvd->get_type())
+        {
+            case XBoardInterface::CommandReceived::PING:
+                m_xboard_interface->reply_ping(*rcvd);
+                break;
+
+            case XBoardInterface::CommandReceived::MOVE_NOW:
+                m_ai->stop();
+                break;
+
+            // Settings for later moves take effect at once and the search carries on.
+            case XBoardInterface::CommandReceived::TIME:
+            case XBoardInterface::CommandReceived::OTIM:
+            case XBoardInterface::CommandReceived::LEVEL:
+            case XBoardInterface::CommandReceived::ST:
+            case XBoardInterface::CommandReceived::POST:
+            case XBoardInterface::CommandReceived::HARD:
+            case XBoardInterface::CommandReceived::EASY:
+            case XBoardInterface::CommandReceived::RANDOM:
+            case XBoardInterface::CommandReceived::NONE:
+                apply_setting(*rcvd);
+                break;
+
+            // These change the search threads or tables, so they wait until the move is made.
+            case XBoardInterface::CommandReceived::CORES:
+            case XBoardInterface::CommandReceived::MEMORY:
+            case XBoardInterface::CommandReceived::OPTION:
+                m_pending_commands.push_back(*rcvd);
+                break;
+
+            default:
+                // Anything else (force, new, quit, result, edit, undo...) abandons the search without moving.
+                m_ai->stop();
+                m_ai->finish_move();
+                m_pending_commands.push_back(*rcvd);
+                return std::nullopt;
+        }
+    }
+
+    return m_ai->finish_move();
+}
+
+bool JohnchessApp::make_ai_move(bool ponder_hit)
 {
     auto moving_colour = m_board->get_colour_to_move();
 
-    auto budget = std::chrono::milliseconds(std::max(100, m_time_remaining_cs * 10 / 30));
-    auto deadline = std::chrono::steady_clock::now() + budget;
+    // Both sides' moves are in the history, so our own move count is half of it.
+    SearchLimits limits = m_time_manager.allocate(static_cast<int>(m_move_history.size() / 2));
 
-    ThinkCallback think_cb;
-    if (m_post_mode) {
-        think_cb = [this](uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& principal_variation) {
-            m_xboard_interface->send_thinking(depth, score_cp, elapsed_cs, nodes, principal_variation);
-        };
+    if (ponder_hit)
+    {
+        m_ai->ponder_hit(limits);
+    }
+    else
+    {
+        m_ai->set_history(m_history);
+        m_ai->start_move(*m_board, limits, thinking_callback());
     }
 
-    Move move = m_ai->make_move(*m_board, deadline, think_cb);
+    auto result = wait_for_search();
+    if (!result)
+        return false;
+
+    Move move = *result;
     std::string move_string = move.to_string();
 
+    bool resets_clock = PositionHistory::resets_clock(*m_board, move);
     m_board->make_move(move_string);
     m_move_history.push_back(move);
+    m_history.push(m_hasher.get_hash(*m_board), resets_clock);
 
     m_board->get_all_legal_moves(m_board->get_colour_to_move()); // TODO: this is just to load the state for get_in_check
     if(m_board->get_in_check(moving_colour))
@@ -56,6 +187,7 @@ void JohnchessApp::make_ai_move()
     }
 
     m_xboard_interface->send_move(move_string);
+    return true;
 
     //std::ofstream ofs("current_board.txt");
 
@@ -67,6 +199,71 @@ void JohnchessApp::make_ai_move()
     //ofs.flush();
 }
 
+void JohnchessApp::start_analysis()
+{
+    if (m_board->get_mate(m_board->get_colour_to_move()) != BitBoard::NO_MATE)
+        return;
+
+    SearchLimits limits;
+    limits.infinite = true;
+    limits.multi_pv = m_multi_pv;
+
+    m_analysis_start = limits.start;
+    m_analysis_depth = 0;
+    m_analysis_nodes = 0;
+
+    // Analysis output is always wanted, whether or not 'post' was sent.
+    m_ai->set_history(m_history);
+    m_ai->start_move(*m_board, limits,
+        [this](uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& principal_variation,
+               uint8_t) {
+            m_analysis_depth = depth;
+            m_analysis_nodes = nodes;
+            m_xboard_interface->send_thinking(depth, score_cp, elapsed_cs, nodes, principal_variation,
+                                              mate_in_moves(score_cp));
+        });
+    m_analysis_running = true;
+}
+
+void JohnchessApp::stop_analysis()
+{
+    if (m_analysis_running)
+    {
+        m_ai->stop();
+        m_ai->finish_move();
+        m_analysis_running = false;
+    }
+}
+
+void JohnchessApp::send_analysis_status()
+{
+    int total_moves = static_cast<int>(m_board->get_all_legal_moves(m_board->get_colour_to_move()).size());
+    int elapsed_cs = m_analysis_running ?
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            SearchLimits::clock::now() - m_analysis_start).count() / 10) : 0;
+
+    // Progress within an iteration isn't tracked, so report it as not started.
+    m_xboard_interface->send_analysis_status(elapsed_cs, m_analysis_nodes, m_analysis_depth, total_moves, total_moves);
+}
+
+void JohnchessApp::start_pondering()
+{
+    if (!m_ponder_mode || m_force_mode || m_analyze_mode || m_board->get_mate(m_board->get_colour_to_move()) != BitBoard::NO_MATE)
+        return;
+
+    m_ai->set_history(m_history);
+    m_ponder_move = m_ai->start_pondering(*m_board, thinking_callback());
+}
+
+void JohnchessApp::stop_pondering()
+{
+    if (m_ponder_move)
+    {
+        m_ai->stop_pondering();
+        m_ponder_move.reset();
+    }
+}
+
 bool JohnchessApp::check_game_end()
 {
     PieceColour colour_to_move = m_board->get_colour_to_move();
@@ -93,17 +290,168 @@ bool JohnchessApp::check_game_end()
     return false;
 }
 
+std::vector<JohnchessApp::PruningOption> JohnchessApp::pruning_options()
+{
+    return {
+        { "Reverse futility",        &m_pruning.reverse_futility },
+        { "Reverse futility margin", nullptr, &m_pruning.reverse_futility_margin, 0, 1000 },
+        { "Reverse futility depth",  nullptr, &m_pruning.reverse_futility_depth, 0, 20 },
+        { "Futility",                &m_pruning.futility },
+        { "Futility margin",         nullptr, &m_pruning.futility_margin, 0, 1000 },
+        { "Futility depth",          nullptr, &m_pruning.futility_depth, 0, 20 },
+        { "Razoring",                &m_pruning.razoring },
+        { "Razor margin",            nullptr, &m_pruning.razor_margin, 0, 2000 },
+        { "Razor depth",             nullptr, &m_pruning.razor_depth, 0, 20 },
+        { "Late move pruning",       &m_pruning.late_move_pruning },
+        { "Late move count",         nullptr, &m_pruning.late_move_count, 0, 100 },
+        { "Late move depth",         nullptr, &m_pruning.late_move_depth, 0, 20 },
+    };
+}
+
+void JohnchessApp::set_option(const std::string& name, const std::string& value)
+{
+    for (const auto& option : pruning_options())
+    {
+        if (option.name != name)
+            continue;
+
+        // UCI sends true/false for a check option, xboard 1/0.
+        if (option.enabled)
+            *option.enabled = value == "true" || value == "1";
+        else
+            *option.value = std::clamp(atoi(value.c_str()), option.min, option.max);
+
+        m_ai->set_pruning(m_pruning);
+        return;
+    }
+
+    if (name == "Parallel search")
+    {
+        if (value == "Lazy SMP")
+            m_ai->set_parallel_mode(ParallelMode::LAZY_SMP);
+        else if (value == "ABDADA")
+            m_ai->set_parallel_mode(ParallelMode::ABDADA);
+    }
+    else if (name == "Hash")
+    {
+        int size_mb = atoi(value.c_str());
+        if (size_mb > 0)
+            m_ai->set_hash_size(size_mb);
+    }
+    else if (name == "Threads")
+    {
+        int threads = atoi(value.c_str());
+        if (threads > 0)
+            m_ai->set_threads(threads);
+    }
+    else if (name == "MultiPV")
+    {
+        int lines = atoi(value.c_str());
+        if (lines > 0)
+            m_multi_pv = static_cast<uint8_t>(std::min(lines, MAX_MULTI_PV));
+    }
+}
+
+void JohnchessApp::run_bench()
+{
+    if (m_app_opts->bench == "smp")
+        bench::run_smp(get_output_stream(), static_cast<uint8_t>(m_app_opts->bench_depth));
+    else if (m_app_opts->bench == "parallel")
+        bench::run_parallel(get_output_stream(), static_cast<uint8_t>(m_app_opts->bench_depth));
+    else if (m_app_opts->bench == "batch")
+        bench::run_batch(get_output_stream());
+    else if (m_app_opts->bench == "eval")
+        bench::run_eval(get_output_stream(), m_app_opts->nnue_file.empty() ? nullptr :
+                                             nnue::load_network(m_app_opts->nnue_file));
+    else
+        throw std::runtime_error("Unknown benchmark: " + m_app_opts->bench);
+}
+
+void JohnchessApp::run_eval_epd()
+{
+    std::ifstream in(m_app_opts->eval_epd_file);
+    if (!in)
+        throw std::runtime_error("Cannot open " + m_app_opts->eval_epd_file);
+
+    try
+    {
+        batch_eval::evaluate_epd(in, get_output_stream(), m_app_opts->threads,
+                                 m_app_opts->skip_bad_epd_lines ? &std::cerr : nullptr);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw std::runtime_error(m_app_opts->eval_epd_file + ": " + e.what());
+    }
+}
+
 void JohnchessApp::main_loop()
 {
+    if (!m_app_opts->bench.empty())
+    {
+        run_bench();
+        return;
+    }
+    if (!m_app_opts->eval_epd_file.empty())
+    {
+        run_eval_epd();
+        return;
+    }
+
+    // Read input in the background so commands are still answered while the engine is thinking.
+    m_input->start();
+
+    // The first command tells us which protocol the GUI speaks.
+    std::string first_command = m_input->read_line();
+    if (UciInterface::CommandReceived(first_command).get_type() == UciInterface::CommandReceived::UCI)
+    {
+        uci_loop();
+        return;
+    }
+
+    m_pending_commands.push_back(XBoardInterface::CommandReceived(first_command));
+    xboard_loop();
+}
+
+void JohnchessApp::xboard_loop()
+{
+    show_welcome();
+
     bool finished = false;
     while(!finished)
     {
-        XBoardInterface::CommandReceived rcvd = m_xboard_interface->wait_for_command();
+        XBoardInterface::CommandReceived rcvd = m_pending_commands.empty() ?
+            m_xboard_interface->wait_for_command() :
+            m_pending_commands.front();
+        if (!m_pending_commands.empty())
+            m_pending_commands.pop_front();
         if (rcvd.is_invalid()){
             m_xboard_interface->reply_invalid(rcvd);
             continue;
         }
 
+        // Clock updates, pings and status requests don't disturb a background search. A move ends
+        // pondering one way or the other and restarts analysis, and anything else abandons both.
+        switch(rcvd.get_type())
+        {
+            case XBoardInterface::CommandReceived::MOVE:
+                stop_analysis();
+                break;
+
+            case XBoardInterface::CommandReceived::TIME:
+            case XBoardInterface::CommandReceived::OTIM:
+            case XBoardInterface::CommandReceived::PING:
+            case XBoardInterface::CommandReceived::POST:
+            case XBoardInterface::CommandReceived::STATUS:
+            case XBoardInterface::CommandReceived::MOVE_NOW:
+            case XBoardInterface::CommandReceived::NONE:
+                break;
+
+            default:
+                stop_pondering();
+                stop_analysis();
+                break;
+        }
+
         switch(rcvd.get_type())
         {
             case XBoardInterface::CommandReceived::MOVE:
@@ -111,29 +459,57 @@ void JohnchessApp::main_loop()
                 PieceColour colour_to_move = m_board->get_colour_to_move();
 
                 const auto rcvd_move = rcvd.get_move_string();
+
+                // The ponder search only becomes our reply once we are sure to move; until then it
+                // is still abandoned by stop_pondering().
+                bool ponder_hit = m_ponder_move && m_ponder_move->to_string() == rcvd_move;
+                if (!ponder_hit)
+                    stop_pondering();
+
+                bool resets_clock = PositionHistory::resets_clock(*m_board, Move(rcvd_move));
                 m_board->make_move(rcvd_move);
 
                 m_board->get_all_legal_moves(m_board->get_colour_to_move()); // TODO: this is just to load the state for get_in_check
                 if(m_board->get_in_check(colour_to_move))
                 {
+                    stop_pondering();
                     m_board->unmake_move(rcvd_move);
                     m_xboard_interface->reply_illegal_move(rcvd);
                     break;
                 }
 
                 m_move_history.push_back(Move(rcvd_move));
+                m_history.push(m_hasher.get_hash(*m_board), resets_clock);
+
+                // In analyze mode the user is just exploring: no result and no reply.
+                if (m_analyze_mode)
+                {
+                    stop_pondering();
+                    break;
+                }
 
                 // Check whether received move has caused game end
-                if(check_game_end()) break;
+                if(check_game_end())
+                {
+                    stop_pondering();
+                    break;
+                }
 
-                if(!m_force_mode)
+                if(m_force_mode)
+                {
+                    stop_pondering();
+                }
+                else
                 {
-                    make_ai_move();
+                    if (ponder_hit)
+                        m_ponder_move.reset();
+                    if (!make_ai_move(ponder_hit)) break;
                 }
 
                 // Check whether AI move has caused game end
                 if(check_game_end()) break;
 
+                start_pondering();
                 break;
             }
             case XBoardInterface::CommandReceived::INFO_REQ:
@@ -151,6 +527,7 @@ void JohnchessApp::main_loop()
             case XBoardInterface::CommandReceived::NEW:
                 m_board->set_to_start_position();
                 m_move_history.clear();
+                m_history.reset(m_hasher.get_hash(*m_board));
                 m_force_mode = false;
                 break;
 
@@ -158,6 +535,7 @@ void JohnchessApp::main_loop()
                 if (!m_move_history.empty()) {
                     m_board->unmake_move(m_move_history.back());
                     m_move_history.pop_back();
+                    m_history.pop();
                 }
                 break;
 
@@ -166,23 +544,25 @@ void JohnchessApp::main_loop()
                 for (int i = 0; i < 2 && !m_move_history.empty(); ++i) {
                     m_board->unmake_move(m_move_history.back());
                     m_move_history.pop_back();
+                    m_history.pop();
                 }
                 break;
 
             case XBoardInterface::CommandReceived::TIME:
-                if (!rcvd.get_intparams().empty())
-                    m_time_remaining_cs = rcvd.get_intparams().front();
-                break;
-
+            case XBoardInterface::CommandReceived::OTIM:
+            case XBoardInterface::CommandReceived::LEVEL:
+            case XBoardInterface::CommandReceived::ST:
+            case XBoardInterface::CommandReceived::CORES:
+            case XBoardInterface::CommandReceived::OPTION:
             case XBoardInterface::CommandReceived::POST:
-                m_post_mode = true;
+            case XBoardInterface::CommandReceived::HARD:
+            case XBoardInterface::CommandReceived::EASY:
+            case XBoardInterface::CommandReceived::MEMORY:
+                apply_setting(rcvd);
                 break;
 
-            case XBoardInterface::CommandReceived::MEMORY:
-            case XBoardInterface::CommandReceived::LEVEL:
-            case XBoardInterface::CommandReceived::HARD:
+            case XBoardInterface::CommandReceived::MOVE_NOW:   // only meaningful while thinking
             case XBoardInterface::CommandReceived::RANDOM:
-            case XBoardInterface::CommandReceived::OTIM:
             case XBoardInterface::CommandReceived::NONE:
                 break;
 
@@ -190,12 +570,29 @@ void JohnchessApp::main_loop()
                 m_force_mode = true;
                 break;
 
+            case XBoardInterface::CommandReceived::ANALYZE:
+                m_analyze_mode = true;
+                break;
+
+            case XBoardInterface::CommandReceived::EXIT:
+                m_analyze_mode = false;
+                break;
+
+            case XBoardInterface::CommandReceived::STATUS:
+                if (m_analyze_mode)
+                    send_analysis_status();
+                break;
+
             case XBoardInterface::CommandReceived::QUIT:
                 finished = true;
                 break;
 
             case XBoardInterface::CommandReceived::EDIT:
                 m_board->set_from_edit_mode(m_xboard_interface->read_edit_mode());
+                // The edited position starts a new game history: earlier moves can't be taken back
+                // or repeated from here.
+                m_move_history.clear();
+                m_history.reset(m_hasher.get_hash(*m_board));
                 break;
 
             case XBoardInterface::CommandReceived::GO:
@@ -203,15 +600,307 @@ void JohnchessApp::main_loop()
                 // if there are 0 params, this is an immediate go (alternatively it's playother)
                 if (rcvd.get_params().size() == 0)
                 {
-                    make_ai_move();
+                    if (make_ai_move())
+                        start_pondering();
                 }
                 break;
 
         }
 
+        // Whatever changed, keep analysing the current position. The TT is kept between
+        // searches, so the new search picks up where the last one left off.
+        if (m_analyze_mode && !m_analysis_running && !finished)
+            start_analysis();
+
     }
 }
 
+void JohnchessApp::apply_setting(XBoardInterface::CommandReceived rcvd)
+{
+    switch(rcvd.get_type())
+    {
+        case XBoardInterface::CommandReceived::TIME:
+            if (!rcvd.get_intparams().empty())
+                m_time_manager.set_time_remaining(rcvd.get_intparams().front());
+            break;
+
+        case XBoardInterface::CommandReceived::OTIM:
+            if (!rcvd.get_intparams().empty())
+                m_time_manager.set_opponent_time(rcvd.get_intparams().front());
+            break;
+
+        case XBoardInterface::CommandReceived::LEVEL:
+        {
+            auto params = rcvd.get_params();
+            if (params.size() != 3 || !m_time_manager.set_level(params[0], params[1], params[2]))
+                m_xboard_interface->reply_invalid(rcvd);
+            break;
+        }
+
+        case XBoardInterface::CommandReceived::ST:
+            if (!rcvd.get_intparams().empty())
+                m_time_manager.set_fixed_move_time(rcvd.get_intparams().front() * 1000);
+            break;
+
+        case XBoardInterface::CommandReceived::CORES:
+            if (!rcvd.get_intparams().empty() && rcvd.get_intparams().front() > 0)
+                m_ai->set_threads(rcvd.get_intparams().front());
+            break;
+
+        case XBoardInterface::CommandReceived::OPTION:
+        {
+            // 'option NAME=VALUE', where both NAME and VALUE may contain spaces
+            std::string option;
+            for (const auto& p : rcvd.get_params())
+                option += (option.empty() ? "" : " ") + p;
+
+            auto eq = option.find('=');
+            if (eq == std::string::npos)
+                m_xboard_interface->reply_invalid(rcvd);
+            else
+                set_option(option.substr(0, eq), option.substr(eq + 1));
+            break;
+        }
+
+        case XBoardInterface::CommandReceived::POST:
+            m_post_mode = true;
+            break;
+
+        case XBoardInterface::CommandReceived::HARD:
+            m_ponder_mode = true;
+            break;
+
+        case XBoardInterface::CommandReceived::EASY:
+            m_ponder_mode = false;
+            break;
+
+        case XBoardInterface::CommandReceived::MEMORY:
+            if (!rcvd.get_intparams().empty() && rcvd.get_intparams().front() > 0)
+                m_ai->set_hash_size(rcvd.get_intparams().front());
+            break;
+
+        default:
+            break;
+    }
+}
+
+void JohnchessApp::uci_loop()
+{
+    m_uci_interface->reply_uci();
+
+    while (true)
+    {
+        UciInterface::CommandReceived rcvd = m_pending_uci_commands.empty() ?
+            m_uci_interface->wait_for_command() :
+            m_pending_uci_commands.front();
+        if (!m_pending_uci_commands.empty())
+            m_pending_uci_commands.pop_front();
+
+        // Unknown commands are ignored, as the protocol requires.
+        if (rcvd.is_invalid())
+            continue;
+
+        switch (rcvd.get_type())
+        {
+            case UciInterface::CommandReceived::UCI:
+                m_uci_interface->reply_uci();
+                break;
+
+            case UciInterface::CommandReceived::ISREADY:
+                m_uci_interface->reply_readyok();
+                break;
+
+            case UciInterface::CommandReceived::SETOPTION:
+                set_option(rcvd.get_option_name(), rcvd.get_option_value());
+                break;
+
+            case UciInterface::CommandReceived::UCINEWGAME:
+                m_ai->clear_hash();
+                break;
+
+            case UciInterface::CommandReceived::POSITION:
+                uci_position(rcvd);
+                break;
+
+            case UciInterface::CommandReceived::GO:
+                if (!uci_go(rcvd))
+                    return;
+                break;
+
+            case UciInterface::CommandReceived::QUIT:
+                return;
+
+            // Only meaningful during a search, which uci_go() handles itself
+            case UciInterface::CommandReceived::STOP:
+            case UciInterface::CommandReceived::PONDERHIT:
+            case UciInterface::CommandReceived::DEBUG:
+            case UciInterface::CommandReceived::NONE:
+                break;
+        }
+    }
+}
+
+void JohnchessApp::uci_position(const UciInterface::CommandReceived& rcvd)
+{
+    std::string fen = rcvd.get_position_fen();
+
+    BitBoard board;
+    PositionHistory position_history;
+    try
+    {
+        if (fen == "startpos")
+            fen = utils::START_FEN;
+        board = utils::board_from_fen<BitBoard>(fen);
+        position_history.reset(m_hasher.get_hash(board), utils::fen_halfmove_clock(fen));
+    }
+    catch (const std::runtime_error& e)
+    {
+        m_uci_interface->send_info_string(e.what());
+        return;
+    }
+
+    std::vector<Move> history;
+    for (const auto& move_string : rcvd.get_position_moves())
+    {
+        // Resolve the move against the legal moves so it carries full undo information.
+        const auto& legal_moves = board.get_all_legal_moves(board.get_colour_to_move());
+        auto it = std::find_if(legal_moves.begin(), legal_moves.end(),
+                               [&](const Move& m) { return m.to_string() == move_string; });
+        if (it == legal_moves.end())
+        {
+            m_uci_interface->send_info_string("Illegal move: " + move_string);
+            break;
+        }
+
+        Move move = *it;
+        bool resets_clock = PositionHistory::resets_clock(board, move);
+        board.make_move(move);
+        history.push_back(move);
+        position_history.push(m_hasher.get_hash(board), resets_clock);
+    }
+
+    *m_board = board;
+    m_move_history = std::move(history);
+    m_history = std::move(position_history);
+}
+
+bool JohnchessApp::uci_go(const UciInterface::CommandReceived& rcvd)
+{
+    const bool white = m_board->get_colour_to_move() == PieceColour::WHITE;
+    bool pondering = rcvd.has_go_flag("ponder");
+
+    auto our_time = rcvd.get_go_param(white ? "wtime" : "btime");
+    auto their_time = rcvd.get_go_param(white ? "btime" : "wtime");
+    auto increment = rcvd.get_go_param(white ? "winc" : "binc");
+    auto moves_to_go = rcvd.get_go_param("movestogo");
+    auto move_time = rcvd.get_go_param("movetime");
+    auto depth = rcvd.get_go_param("depth");
+    auto nodes = rcvd.get_go_param("nodes");
+
+    SearchLimits limits;
+    TimeManager time_manager;
+    if (move_time)
+    {
+        time_manager.set_fixed_move_time(static_cast<int>(*move_time));
+        limits = time_manager.allocate(0);
+    }
+    else if (our_time)
+    {
+        time_manager.set_level(static_cast<int>(moves_to_go.value_or(0)), static_cast<int>(*our_time),
+                               static_cast<int>(increment.value_or(0)));
+        if (their_time)
+            time_manager.set_opponent_time(static_cast<int>(*their_time / 10));
+        limits = time_manager.allocate(0);
+    }
+
+    if (depth)
+        limits.max_depth = static_cast<uint8_t>(std::clamp<int64_t>(*depth, 1, 20));
+    if (nodes && *nodes > 0)
+        limits.max_nodes = static_cast<uint64_t>(*nodes);
+
+    // A bare 'go' searches until stopped.
+    bool infinite = rcvd.has_go_flag("infinite") ||
+        (!move_time && !our_time && !depth && !nodes);
+    limits.infinite = infinite;
+
+    limits.multi_pv = m_multi_pv;
+
+    ThinkCallback think_cb = [this](uint8_t completed_depth, int score_cp, int elapsed_cs, uint64_t searched_nodes,
+                                    const std::string& pv, uint8_t pv_index) {
+        m_uci_interface->send_info(completed_depth, score_cp, elapsed_cs * 10, searched_nodes, m_ai->hashfull(), pv,
+                                   m_multi_pv > 1 ? std::optional<int>(pv_index) : std::nullopt,
+                                   mate_in_moves(score_cp));
+    };
+
+    m_ai->set_history(m_history);
+    m_ai->start_move(*m_board, limits, think_cb, pondering);
+
+    // bestmove may not be sent during an infinite or ponder search until the GUI says so,
+    // even if the search has already finished. Nothing more is read once the search is stopped,
+    // and any other command waits until bestmove has been sent.
+    bool stopped = false;
+    bool quit = false;
+    while (!stopped && (m_ai->is_thinking() || infinite || pondering))
+    {
+        auto cmd = m_uci_interface->poll_command(COMMAND_POLL_INTERVAL);
+        if (!cmd || cmd->is_invalid())
+            continue;
+
+        switch (cmd->get_type())
+        {
+            case UciInterface::CommandReceived::STOP:
+                m_ai->stop();
+                stopped = true;
+                break;
+
+            case UciInterface::CommandReceived::PONDERHIT:
+                if (pondering)
+                {
+                    // The clock starts now that it is really our move.
+                    m_ai->ponder_hit(limits.restarted_at(SearchLimits::clock::now()));
+                    pondering = false;
+                }
+                break;
+
+            case UciInterface::CommandReceived::ISREADY:
+                m_uci_interface->reply_readyok();
+                break;
+
+            case UciInterface::CommandReceived::QUIT:
+                m_ai->stop();
+                stopped = quit = true;
+                break;
+
+            case UciInterface::CommandReceived::DEBUG:
+            case UciInterface::CommandReceived::NONE:
+                break;
+
+            default:
+                m_pending_uci_commands.push_back(*cmd);
+                break;
+        }
+    }
+
+    Move best = m_ai->finish_move();
+    if (quit)
+        return false;
+
+    // Checkmate or stalemate: there is no move to make, which UCI writes as the null move.
+    if (!best.is_valid())
+    {
+        m_uci_interface->send_bestmove("0000", std::nullopt);
+        return true;
+    }
+
+    BitBoard after(*m_board);
+    after.make_move(best);
+    auto ponder_move = m_ai->hash_move(after);
+
+    m_uci_interface->send_bestmove(best.to_string(),
+                                   ponder_move ? std::optional<std::string>(ponder_move->to_string()) : std::nullopt);
+    return true;
+}
+
 void JohnchessApp::show_welcome()
 {
     m_xboard_interface->tell_info("   Johnchess 0.1");
@@ -234,9 +923,84 @@ std::ostream& JohnchessApp::get_output_stream()
     return std::cout;
 }
 
+std::string JohnchessApp::usage()
+{
+    return
+        "Usage: johnchess [options]\n"
+        "  --threads N          number of search threads (default: one per hardware thread)\n"
+        "  --smp-mode MODE      parallel search algorithm: lazy (default) or abdada\n"
+        "  --nnue FILE          evaluate with the neural network in FILE instead of the handwritten evaluation\n"
+        "  --bench NAME         run the smp, parallel, eval or batch benchmark and exit\n"
+        "  --depth N            depth searched by --bench (default 7)\n"
+        "  --eval-epd FILE      write each EPD or FEN position in FILE with its evaluation and exit\n"
+        "  --epd-errors MODE    on a malformed --eval-epd line: fail (default) or skip it with a warning\n";
+}
+
 JohnchessApp::app_opts_t* JohnchessApp::parse_args(int argc, const char* argv[])
 {
     JohnchessApp::app_opts_t *opts = new JohnchessApp::app_opts_t;
 
+    auto fail = [&](const std::string& message) {
+        delete opts;
+        throw ArgumentError(message);
+    };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+
+        if (arg != "--threads" && arg != "--smp-mode" && arg != "--bench" && arg != "--eval-epd" &&
+            arg != "--epd-errors" && arg != "--nnue" && arg != "--depth")
+        {
+            fail("Unknown argument: " + arg);
+        }
+        if (i + 1 >= argc)
+            fail(arg + " needs a value");
+
+        std::string value(argv[++i]);
+
+        if (arg == "--threads")
+        {
+            int threads = atoi(value.c_str());
+            if (threads < 1)
+                fail("--threads must be at least 1");
+            opts->threads = threads;
+        }
+        else if (arg == "--smp-mode")
+        {
+            if (value == "lazy")
+                opts->parallel_mode = ParallelMode::LAZY_SMP;
+            else if (value == "abdada")
+                opts->parallel_mode = ParallelMode::ABDADA;
+            else
+                fail("--smp-mode must be lazy or abdada");
+        }
+        else if (arg == "--bench")
+        {
+            opts->bench = value;
+        }
+        else if (arg == "--eval-epd")
+        {
+            opts->eval_epd_file = value;
+        }
+        else if (arg == "--epd-errors")
+        {
+            if (value == "fail")
+                opts->skip_bad_epd_lines = false;
+            else if (value == "skip")
+                opts->skip_bad_epd_lines = true;
+            else
+                fail("--epd-errors must be fail or skip");
+        }
+        else if (arg == "--nnue")
+        {
+            opts->nnue_file = value;
+        }
+        else // --depth
+        {
+            opts->bench_depth = std::clamp(atoi(value.c_str()), 1, 20);
+        }
+    }
+
     return opts;
 }
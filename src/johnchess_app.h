@@ -1,36 +1,85 @@
 #pragma once
 
+#include <deque>
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include "input_reader.h"
+#include "uci_interface.h"
 #include "xboard_interface.h"
 
 #include "bitboards/bitboard.h"
 #include "ai.h"
+#include "time_manager.h"
 
 class JohnchessApp {
 private:
     typedef struct app_opts {
         std::istream *in_stream;
         std::ostream *out_stream;
-        app_opts() : in_stream(NULL), out_stream(NULL) {}
+        unsigned threads;   // 0 = one per hardware thread
+        ParallelMode parallel_mode;
+        std::string bench;  // benchmark to run instead of the protocol loop, if set
+        int bench_depth;
+        std::string nnue_file;  // network to evaluate with instead of ShannonHeuristic, if set
+        std::string eval_epd_file;  // EPD or FEN file to score instead of the protocol loop, if set
+        bool skip_bad_epd_lines;    // report malformed EPD lines and carry on, rather than stop
+        app_opts() : in_stream(NULL), out_stream(NULL), threads(0), parallel_mode(ParallelMode::LAZY_SMP), bench_depth(7),
+                     skip_bad_epd_lines(false) {}
     } app_opts_t;
 
+public:
+    //! Thrown for a command line argument that is unknown, missing its value or has a bad one
+    class ArgumentError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    //! Summary of the command line options
+    static std::string usage();
+
 public: //ctor + dtor
+    //! \throw ArgumentError if the arguments can't be used
     JohnchessApp(int argc, const char* argv[]);
+    //! Talk to the GUI over the given streams instead of stdin and stdout
+    JohnchessApp(int argc, const char* argv[], std::istream& in, std::ostream& out);
     ~JohnchessApp();
 
 public: //public methods
     void main_loop();
 
 private:
+    std::shared_ptr<InputReader> m_input;
     std::unique_ptr<XBoardInterface> m_xboard_interface;
+    std::unique_ptr<UciInterface> m_uci_interface;
     std::unique_ptr<BitBoard> m_board;
     std::unique_ptr<AI> m_ai;
 
+    JohnchessApp(int argc, const char* argv[], std::istream* in, std::ostream* out);
+
     app_opts_t* parse_args(int argc, const char* argv[]);
     void show_welcome();
-    void make_ai_move();
+    void xboard_loop();
+    void uci_loop();
+    void uci_position(const UciInterface::CommandReceived& rcvd);
+    bool uci_go(const UciInterface::CommandReceived& rcvd);   // false if the GUI quit during the search
+    void run_bench();
+    void run_eval_epd();
+    void set_option(const std::string& name, const std::string& value);
+    bool make_ai_move(bool ponder_hit = false);
+    std::optional<Move> wait_for_search();
+    void apply_setting(XBoardInterface::CommandReceived rcvd);
+    void start_pondering();
+    void stop_pondering();
+    void start_analysis();
+    void stop_analysis();
+    void send_analysis_status();
+    ThinkCallback thinking_callback();
     bool check_game_end();
 
     app_opts_t* m_app_opts;
@@ -38,7 +87,46 @@ private:
     std::ostream& get_output_stream();
     bool m_force_mode;
     bool m_post_mode = false;
+    bool m_ponder_mode = false;
+    std::optional<Move> m_ponder_move;  // expected reply, while a ponder search is running
+
+    // Selective pruning settings, each exposed as an engine option for tuning
+    struct PruningOption
+    {
+        std::string name;
+        bool* enabled = nullptr;    // a check option if set, otherwise a spin option on value
+        int* value = nullptr;
+        int min = 0;
+        int max = 0;
+    };
+    PruningParams m_pruning;
+    std::vector<PruningOption> pruning_options();
+
+    // Number of best lines to search and report, for UCI searches and xboard analyze mode
+    static constexpr int MAX_MULTI_PV = 16;
+    uint8_t m_multi_pv = 1;
+
+    // xboard analyze mode: an infinite search of the current position, restarted whenever it changes
+    bool m_analyze_mode = false;
+    bool m_analysis_running = false;
+    SearchLimits::clock::time_point m_analysis_start;
+    std::atomic<uint8_t> m_analysis_depth = 0;    // last completed depth, written by the search thread
+    std::atomic<uint64_t> m_analysis_nodes = 0;
+
+    // Commands read during a search that the main loop handles next: settings that have to wait
+    // for the search to finish, then any command that interrupted it
+    std::deque<XBoardInterface::CommandReceived> m_pending_commands;
+    // Commands the GUI sent during a UCI search, handled once bestmove has been sent
+    std::deque<UciInterface::CommandReceived> m_pending_uci_commands;
+
+    // How long the main loop waits for input before checking on a running search
+    static constexpr std::chrono::milliseconds COMMAND_POLL_INTERVAL{1};
     std::vector<Move> m_move_history;
-    int m_time_remaining_cs = 30000; // centiseconds, updated by TIME command
+
+    // Keys of the game positions, kept in step with m_board and m_move_history
+    ZobristHash m_hasher;
+    PositionHistory m_history;
+
+    TimeManager m_time_manager;
 
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hash_stats.h"
+#include "piece_types.h"
+#include "score.h"
+
+// A material key counts the pieces of each type and colour, kings excluded, in four bits each:
+// queens, rooks, bishops, knights and pawns of white in the low 20 bits, then the same for black.
+// Any count that can occur in a game fits, so equal keys always mean equal material.
+namespace material_key
+{
+
+constexpr int shift(PieceType type, bool white)
+{
+    return 4 * (static_cast<int>(type) - 1 + (white ? 0 : 5));
+}
+
+//! Change in the key for one piece of the given type and colour
+constexpr uint64_t unit(PieceType type, bool white)
+{
+    return type == PieceType::KING ? 0 : 1ULL << shift(type, white);
+}
+
+constexpr int count(uint64_t key, PieceType type, bool white)
+{
+    return static_cast<int>((key >> shift(type, white)) & 0xF);
+}
+
+}
+
+// Evaluation terms that depend only on how many pieces of each kind are left
+struct MaterialEntry {
+    uint64_t key = ~0ULL;   // impossible key, as each count would be 15
+    Score imbalance = 0;    // white's less black's
+    uint8_t phase = 0;      // non-pawn material, from 0 (endgame) to piece_square_tables::FULL_PHASE
+    bool draw = false;      // neither side has enough material to force mate
+};
+
+// Material cache, indexed by BitBoard::get_material_key(). Each search thread has its own table,
+// so it needs no locking.
+class MaterialTable
+{
+private:
+    static constexpr int INDEX_BITS = 13;
+
+    std::vector<MaterialEntry> m_entries;
+    HashStats m_stats;
+
+public:
+    MaterialTable() : m_entries(size_t(1) << INDEX_BITS) {}
+
+    //! Entry for a material key, which the caller must fill in if it wasn't found
+    MaterialEntry& probe(uint64_t key, bool& found)
+    {
+        // Material keys are far from random, so spread them over the table.
+        MaterialEntry& e = m_entries[(key * 0x9E3779B97F4A7C15ULL) >> (64 - INDEX_BITS)];
+        found = e.key == key;
+
+        ++m_stats.probes;
+        if (found)
+            ++m_stats.hits;
+        else
+            e.key = key;
+
+        return e;
+    }
+
+    const HashStats& stats() const { return m_stats; }
+    void reset_stats() { m_stats = {}; }
+};
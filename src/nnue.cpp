@@ -0,0 +1,176 @@
+#include "nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "cpu_dispatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace nnue;
+
+// The kernels below work on whole multiples of HIDDEN_STEP values. AVX2 versions are built when
+// the compiler targets it (JOHNCHESS_AVX2 in CMake). Otherwise the scalar loops are used, with an
+// AVX2 build of them picked at load time where the CPU supports it.
+
+AVX2_CLONES
+static void add_weights(int16_t* acc, const int16_t* weights, int n)
+{
+#if defined(__AVX2__)
+    for (int i = 0; i < n; i += 16)
+    {
+        auto* a = reinterpret_cast<__m256i*>(acc + i);
+        auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(a, _mm256_add_epi16(_mm256_loadu_si256(a), w));
+    }
+#else
+    for (int i = 0; i < n; ++i)
+        acc[i] = static_cast<int16_t>(acc[i] + weights[i]);
+#endif
+}
+
+AVX2_CLONES
+static void sub_weights(int16_t* acc, const int16_t* weights, int n)
+{
+#if defined(__AVX2__)
+    for (int i = 0; i < n; i += 16)
+    {
+        auto* a = reinterpret_cast<__m256i*>(acc + i);
+        auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(a, _mm256_sub_epi16(_mm256_loadu_si256(a), w));
+    }
+#else
+    for (int i = 0; i < n; ++i)
+        acc[i] = static_cast<int16_t>(acc[i] - weights[i]);
+#endif
+}
+
+// Sum of clamp(acc, 0, QA) * weights
+AVX2_CLONES
+static int32_t clipped_dot(const int16_t* acc, const int8_t* weights, int n)
+{
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(QA);
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+
+    for (int i = 0; i < n; i += 32)
+    {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 16));
+        lo = _mm256_min_epi16(_mm256_max_epi16(lo, zero), qa);
+        hi = _mm256_min_epi16(_mm256_max_epi16(hi, zero), qa);
+
+        // Packing works within each 128-bit lane, so put the 64-bit quarters back in order.
+        __m256i activations = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+
+        // Activations fit in 7 bits, so the pairwise int16 sums can't saturate.
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(activations, w), ones));
+    }
+
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += std::clamp<int32_t>(acc[i], 0, QA) * weights[i];
+    return sum;
+#endif
+}
+
+template <typename T>
+static void read_values(std::istream& in, T* values, size_t count)
+{
+    // Files are little-endian, like every machine this is built for.
+    in.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!in)
+        throw std::runtime_error("NNUE network file is truncated");
+}
+
+Network::Network(std::istream& in)
+{
+    char magic[4] = {};
+    uint32_t version = 0, hidden = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, "JCNN", sizeof(magic)) != 0)
+        throw std::runtime_error("Not an NNUE network file");
+
+    read_values(in, &version, 1);
+    if (version != 1)
+        throw std::runtime_error("Unsupported NNUE network version " + std::to_string(version));
+
+    read_values(in, &hidden, 1);
+    if (hidden == 0 || hidden > MAX_HIDDEN || hidden % HIDDEN_STEP != 0)
+        throw std::runtime_error("Bad NNUE hidden layer size " + std::to_string(hidden));
+    m_hidden = static_cast<int>(hidden);
+
+    m_input_weights.resize(size_t(INPUTS) * m_hidden);
+    m_input_biases.resize(m_hidden);
+    m_output_weights.resize(2 * size_t(m_hidden));
+
+    read_values(in, m_input_weights.data(), m_input_weights.size());
+    read_values(in, m_input_biases.data(), m_input_biases.size());
+    read_values(in, m_output_weights.data(), m_output_weights.size());
+    read_values(in, &m_output_bias, 1);
+
+    if (in.peek() != std::char_traits<char>::eof())
+        throw std::runtime_error("NNUE network file is too long");
+}
+
+int Network::evaluate(const int16_t* us, const int16_t* them) const
+{
+    int64_t output = int64_t(clipped_dot(us, m_output_weights.data(), m_hidden))
+                   + clipped_dot(them, m_output_weights.data() + m_hidden, m_hidden) + m_output_bias;
+
+    int64_t centipawns = output * OUTPUT_SCALE / (QA * QB);
+    return static_cast<int>(std::clamp<int64_t>(centipawns, -MAX_EVAL, MAX_EVAL));
+}
+
+std::shared_ptr<const Network> nnue::load_network(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Can't open NNUE network file " + path);
+
+    return std::make_shared<const Network>(in);
+}
+
+Accumulator::Accumulator(std::shared_ptr<const Network> network) :
+    m_network(std::move(network)),
+    m_values(2 * size_t(m_network->hidden_size()))
+{
+    clear();
+}
+
+void Accumulator::clear()
+{
+    const int n = m_network->hidden_size();
+    std::copy_n(m_network->input_biases(), n, side(true));
+    std::copy_n(m_network->input_biases(), n, side(false));
+}
+
+void Accumulator::update(PieceType type, bool white, uint8_t sq, int sign)
+{
+    const int n = m_network->hidden_size();
+    for (bool perspective : { true, false })
+    {
+        const int16_t* weights = m_network->input_weights(feature(type, white, sq, perspective));
+        if (sign > 0)
+            add_weights(side(perspective), weights, n);
+        else
+            sub_weights(side(perspective), weights, n);
+    }
+}
+
+int Accumulator::evaluate(bool white_to_move) const
+{
+    return m_network->evaluate(side(white_to_move), side(!white_to_move));
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "piece_types.h"
+
+// Neural network evaluation, an alternative to ShannonHeuristic.
+//
+// Each side sees the board from its own point of view: one input per piece type, square and
+// whether the piece is its own or the opponent's, with squares mirrored for black (768 inputs).
+// The inputs are sparse and change by a few pieces per move, so the first layer's output, the
+// accumulator, is kept up to date by the board as pieces move instead of being recomputed.
+// The two sides' accumulators, side to move first, pass through a clipped ReLU to one output.
+//
+// Values are quantised: int16 first layer weights and accumulator, activations clipped to
+// [0, QA], and int8 output weights scaled by QB.
+namespace nnue
+{
+
+inline constexpr int INPUTS = 768;
+inline constexpr int MAX_HIDDEN = 1024;
+
+// Hidden layer sizes must be a multiple of this, so the SIMD kernels need no remainder loop.
+inline constexpr int HIDDEN_STEP = 32;
+
+inline constexpr int QA = 127;
+inline constexpr int QB = 64;
+
+// Centipawns per unit of network output
+inline constexpr int OUTPUT_SCALE = 400;
+
+// Evaluations are clamped to this, in centipawns, to keep them clear of mate scores.
+inline constexpr int MAX_EVAL = 10000;
+
+//! Input index of a piece, as seen by one side
+constexpr int feature(PieceType type, bool piece_white, uint8_t sq, bool perspective_white)
+{
+    const int relative_colour = piece_white == perspective_white ? 0 : 1;
+    const int relative_sq = perspective_white ? sq : sq ^ 56;
+    return (relative_colour * 6 + static_cast<int>(type)) * 64 + relative_sq;
+}
+
+// Weights of a network, read from a file in this layout (little-endian):
+//   "JCNN", uint32 version (1), uint32 hidden size
+//   int16 input weights [INPUTS][hidden], int16 input biases [hidden]
+//   int8 output weights [2][hidden] (side to move's half first), int32 output bias
+class Network
+{
+private:
+    int m_hidden = 0;
+    std::vector<int16_t> m_input_weights;
+    std::vector<int16_t> m_input_biases;
+    std::vector<int8_t> m_output_weights;
+    int32_t m_output_bias = 0;
+
+public:
+    //! Read a network, throwing std::runtime_error if it is malformed
+    explicit Network(std::istream& in);
+
+    int hidden_size() const { return m_hidden; }
+
+    const int16_t* input_biases() const { return m_input_biases.data(); }
+    const int16_t* input_weights(int feature) const { return &m_input_weights[size_t(feature) * m_hidden]; }
+    const int8_t* output_weights() const { return m_output_weights.data(); }
+    int32_t output_bias() const { return m_output_bias; }
+
+    //! Evaluation in centipawns from the accumulators of the side to move and its opponent
+    int evaluate(const int16_t* us, const int16_t* them) const;
+};
+
+//! Read a network from a file, throwing std::runtime_error if it can't be read or is malformed
+std::shared_ptr<const Network> load_network(const std::string& path);
+
+// First layer output for both sides, as kept by BitBoard
+class Accumulator
+{
+private:
+    std::shared_ptr<const Network> m_network;
+    std::vector<int16_t> m_values;  // white's side, then black's
+
+    int16_t* side(bool white) { return &m_values[white ? 0 : m_network->hidden_size()]; }
+
+public:
+    //! Accumulator of an empty board
+    explicit Accumulator(std::shared_ptr<const Network> network);
+
+    //! Back to an empty board
+    void clear();
+
+    //! Add (sign 1) or remove (sign -1) a piece
+    void update(PieceType type, bool white, uint8_t sq, int sign);
+
+    //! Evaluation in centipawns for the side to move
+    int evaluate(bool white_to_move) const;
+
+    const int16_t* side(bool white) const { return &m_values[white ? 0 : m_network->hidden_size()]; }
+    const std::shared_ptr<const Network>& get_network() const { return m_network; }
+};
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "hash_stats.h"
+#include "score.h"
+
+// Evaluation terms that depend only on where the pawns are
+struct PawnEntry {
+    uint64_t key = 0;
+    Score score = 0;                    // doubled, isolated and passed pawns, white's less black's
+    std::array<uint64_t, 2> passed{};   // passed pawns of white and black
+};
+
+// Pawn structure cache, indexed by BitBoard::get_pawn_key(). Pawn structure changes in few moves,
+// so most evaluations find their entry. Each search thread has its own table, so it needs no locking.
+class PawnHashTable
+{
+private:
+    static constexpr size_t ENTRIES = 1 << 14;
+
+    std::vector<PawnEntry> m_entries;
+    HashStats m_stats;
+
+public:
+    PawnHashTable() : m_entries(ENTRIES) {}
+
+    //! Entry for a pawn key, which the caller must fill in if it wasn't found
+    /*!
+     * Empty entries are those for no pawns, which is what they hold.
+     */
+    PawnEntry& probe(uint64_t key, bool& found)
+    {
+        PawnEntry& e = m_entries[key & (ENTRIES - 1)];
+        found = e.key == key;
+
+        ++m_stats.probes;
+        if (found)
+            ++m_stats.hits;
+        else
+            e.key = key;
+
+        return e;
+    }
+
+    const HashStats& stats() const { return m_stats; }
+    void reset_stats() { m_stats = {}; }
+};
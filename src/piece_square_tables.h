@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "piece_types.h"
+#include "score.h"
+
+// Material values and piece-square tables shared by the evaluation and the running totals kept in
+// BitBoard, in centipawns. All arrays indexed by piece are in PieceType order (king, queen, rook,
+// bishop, knight, pawn).
+namespace piece_square_tables
+{
+
+inline constexpr Score MATERIAL[6] = { S(20000, 20000), S(900, 900), S(500, 500), S(300, 300), S(300, 300), S(100, 100) };
+
+// Non-pawn material still on the board sets the game phase: full material weight = 2Q + 4R + 4B + 4N = 62.
+inline constexpr int PHASE_WEIGHT[6] = { 0, 9, 5, 3, 3, 0 };
+inline constexpr int FULL_PHASE = 62;
+
+// PSTs defined from White's perspective, index 0=a1 through 63=h8.
+// Rows written rank-8 first for visual readability.
+
+// clang-format off
+inline constexpr int PAWN[64] = {
+    // rank 1
+       0,    0,    0,    0,    0,    0,    0,    0,
+    // rank 2
+      -5,   -5,   -5,    0,    0,   -5,   -5,   -5,
+    // rank 3
+       5,   -5,  -10,    0,    0,  -10,   -5,    5,
+    // rank 4
+       0,    0,    0,   20,   20,    0,    0,    0,
+    // rank 5
+       5,    5,   10,   25,   25,   10,    5,    5,
+    // rank 6
+      10,   10,   20,   30,   30,   20,   10,   10,
+    // rank 7 (one step from promotion)
+      50,   60,   60,   70,   70,   60,   60,   50,
+    // rank 8
+       0,    0,    0,    0,    0,    0,    0,    0,
+};
+
+inline constexpr int KNIGHT[64] = {
+    // rank 1
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+    // rank 2
+     -40,  -20,    0,    5,    5,    0,  -20,  -40,
+    // rank 3
+     -30,    5,   10,   15,   15,   10,    5,  -30,
+    // rank 4
+     -30,    0,   15,   20,   20,   15,    0,  -30,
+    // rank 5
+     -30,    5,   15,   20,   20,   15,    5,  -30,
+    // rank 6
+     -30,    0,   10,   15,   15,   10,    0,  -30,
+    // rank 7
+     -40,  -20,    0,    0,    0,    0,  -20,  -40,
+    // rank 8
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+};
+
+inline constexpr int BISHOP[64] = {
+    // rank 1
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+    // rank 2
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+    // rank 3
+     -10,    0,    5,   10,   10,    5,    0,  -10,
+    // rank 4
+     -10,    5,    5,   10,   10,    5,    5,  -10,
+    // rank 5
+     -10,    0,   10,   10,   10,   10,    0,  -10,
+    // rank 6
+     -10,   10,   10,   10,   10,   10,   10,  -10,
+    // rank 7
+     -10,    5,    0,    0,    0,    0,    5,  -10,
+    // rank 8
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+};
+
+inline constexpr int ROOK[64] = {
+    // rank 1
+       0,    0,    0,    0,    0,    0,    0,    0,
+    // rank 2
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+    // rank 3
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+    // rank 4
+       0,    0,    0,    5,    5,    0,    0,    0,
+    // rank 5
+       5,    5,    5,    5,    5,    5,    5,    5,
+    // rank 6
+      10,   10,   10,   10,   10,   10,   10,   10,
+    // rank 7 (dominant on 7th rank)
+      10,   10,   10,   10,   10,   10,   10,   10,
+    // rank 8
+       0,    0,    5,    5,    5,    5,    0,    0,
+};
+
+inline constexpr int QUEEN[64] = {
+    // rank 1
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+    // rank 2
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+    // rank 3
+     -10,    0,    5,    5,    5,    5,    0,  -10,
+    // rank 4
+      -5,    0,    5,    5,    5,    5,    0,   -5,
+    // rank 5
+       0,    0,    5,    5,    5,    5,    0,   -5,
+    // rank 6
+     -10,    5,    5,    5,    5,    5,    0,  -10,
+    // rank 7
+     -10,    0,    5,    0,    0,    0,    0,  -10,
+    // rank 8
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+};
+
+// Middlegame: reward castled position, penalise centre exposure.
+inline constexpr int KING_MG[64] = {
+    // rank 1
+      20,   30,   10,    0,    0,   10,   30,   20,
+    // rank 2
+      20,   20,    0,    0,    0,    0,   20,   20,
+    // rank 3
+     -10,  -20,  -20,  -20,  -20,  -20,  -20,  -10,
+    // rank 4
+     -20,  -30,  -30,  -40,  -40,  -30,  -30,  -20,
+    // rank 5
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+    // rank 6
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+    // rank 7
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+    // rank 8
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+};
+
+// Endgame: king should centralise and become active.
+inline constexpr int KING_EG[64] = {
+    // rank 1
+     -50,  -30,  -30,  -30,  -30,  -30,  -30,  -50,
+    // rank 2
+     -30,  -30,    0,    0,    0,    0,  -30,  -30,
+    // rank 3
+     -30,  -10,   20,   30,   30,   20,  -10,  -30,
+    // rank 4
+     -30,  -10,   30,   40,   40,   30,  -10,  -30,
+    // rank 5
+     -30,  -10,   30,   40,   40,   30,  -10,  -30,
+    // rank 6
+     -30,  -10,   20,   30,   30,   20,  -10,  -30,
+    // rank 7
+     -30,  -20,  -10,    0,    0,  -10,  -20,  -30,
+    // rank 8
+     -50,  -40,  -30,  -20,  -20,  -30,  -40,  -50,
+};
+// clang-format on
+
+//! Table index of a square for a piece of the given colour (black's squares are mirrored)
+constexpr uint8_t table_square(uint8_t sq, bool white) { return white ? sq : sq ^ 56; }
+
+// Material plus position for each piece and square, from White's side. Only the king's position
+// is valued differently in the endgame.
+inline constexpr auto PIECE_SQUARE = [] {
+    const int* middlegame[6] = { KING_MG, QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+    const int* endgame[6]    = { KING_EG, QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+
+    std::array<std::array<Score, 64>, 6> table{};
+    for (int piece = 0; piece < 6; ++piece)
+    {
+        for (int sq = 0; sq < 64; ++sq)
+            table[piece][sq] = MATERIAL[piece] + S(middlegame[piece][sq], endgame[piece][sq]);
+    }
+    return table;
+}();
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitboards/bitboard.h"
+#include "move.h"
+
+// Hash keys of the positions in the game so far, followed by those on the current search path,
+// each with its halfmove clock (plies since the last capture or pawn move). A position can only
+// repeat one reached since the last capture or pawn move, so the repetition check only looks
+// back that far.
+class PositionHistory
+{
+private:
+    struct Entry
+    {
+        uint64_t key;
+        int halfmove_clock;
+    };
+
+    std::vector<Entry> m_entries;
+
+public:
+    // Fifty moves by each side without a capture or pawn move is a draw.
+    static constexpr int FIFTY_MOVE_PLIES = 100;
+
+    PositionHistory() { m_entries.reserve(256); }
+
+    //! Start a new history at the given position
+    void reset(uint64_t key, int halfmove_clock = 0)
+    {
+        m_entries.clear();
+        m_entries.push_back({ key, halfmove_clock });
+    }
+
+    //! Record the position reached by a move
+    /*!
+     * \param resets_clock whether the move was a capture or pawn move, see resets_clock()
+     */
+    void push(uint64_t key, bool resets_clock)
+    {
+        int clock = resets_clock || m_entries.empty() ? 0 : m_entries.back().halfmove_clock + 1;
+        m_entries.push_back({ key, clock });
+    }
+
+    void pop() { m_entries.pop_back(); }
+
+    //! Whether a move made on this board is irreversible (a capture or pawn move)
+    static bool resets_clock(const BitBoard& board, const Move& move)
+    {
+        uint64_t from = 1ULL << move.get_from_loc().get_raw();
+        uint64_t to = 1ULL << move.get_to_loc().get_raw();
+        return (board.get_pawns() & from) || (board.get_occupied() & to);
+    }
+
+    //! Key of the current position
+    uint64_t key() const { return m_entries.back().key; }
+
+    int halfmove_clock() const { return m_entries.back().halfmove_clock; }
+
+    //! Whether the current position occurred before, with the same side to move
+    bool is_repetition() const
+    {
+        const size_t n = m_entries.size();
+        const Entry& current = m_entries.back();
+
+        // The side to move must match, and it takes at least four plies to get back.
+        for (size_t back = 4; back <= static_cast<size_t>(current.halfmove_clock) && back < n; back += 2)
+        {
+            if (m_entries[n - 1 - back].key == current.key)
+                return true;
+        }
+        return false;
+    }
+
+    bool is_fifty_move_draw() const { return halfmove_clock() >= FIFTY_MOVE_PLIES; }
+
+    bool empty() const { return m_entries.empty(); }
+    size_t size() const { return m_entries.size(); }
+};
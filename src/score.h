@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+// Evaluation terms carry a middlegame and an endgame value in centipawns, packed into one integer
+// so they can be added, subtracted and scaled together: the endgame value in the upper 16 bits
+// and the middlegame value in the lower 16 bits, borrowing from the upper half when negative.
+// The evaluator tapers between the two only once, at the end.
+using Score = int32_t;
+
+constexpr Score S(int mg, int eg)
+{
+    return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+}
+
+constexpr int mg_value(Score s)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s)));
+}
+
+constexpr int eg_value(Score s)
+{
+    // Add back the borrow taken by a negative middlegame value.
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s + 0x8000) >> 16));
+}
+
+//! Blend the two values of a score by game phase
+/*!
+ * \param phase from 0 (endgame) to full_phase (middlegame)
+ * \return centipawns
+ */
+constexpr int taper(Score s, int phase, int full_phase)
+{
+    return (mg_value(s) * phase + eg_value(s) * (full_phase - phase)) / full_phase;
+}
@@ -0,0 +1,316 @@
+#include "search_thread_pool.h"
+
+#include <algorithm>
+
+SearchThreadPool::SearchThreadPool(unsigned n_threads) :
+    m_tt(std::make_unique<TranspositionTable>())
+{
+    start_threads(n_threads);
+}
+
+SearchThreadPool::~SearchThreadPool()
+{
+    stop();
+    stop_threads();
+}
+
+void SearchThreadPool::start_threads(unsigned n_threads)
+{
+    n_threads = std::max(1u, n_threads);
+
+    m_quit = false;
+    m_threads.reserve(n_threads);
+    for (unsigned i = 0; i < n_threads; ++i)
+    {
+        m_threads.push_back(std::make_unique<SearchThread>(*m_tt, m_hasher, m_stop, m_ponder));
+        m_threads.back()->tree.set_abdada_table(m_mode == ParallelMode::ABDADA ? &m_abdada : nullptr);
+        m_threads.back()->tree.set_pruning(m_pruning);
+    }
+
+    // Start the threads only once m_threads is fully built, as they index into it.
+    for (unsigned i = 0; i < n_threads; ++i)
+        m_threads[i]->thread = std::thread(&SearchThreadPool::thread_loop, this, i, m_generation);
+}
+
+void SearchThreadPool::stop_threads()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_done_cv.wait(lock, [&] { return m_running == 0; });
+        m_quit = true;
+    }
+    m_start_cv.notify_all();
+
+    for (auto& t : m_threads)
+        t->thread.join();
+
+    m_threads.clear();
+}
+
+void SearchThreadPool::resize(unsigned n_threads)
+{
+    if (std::max(1u, n_threads) == size())
+        return;
+
+    stop_threads();
+    start_threads(n_threads);
+}
+
+void SearchThreadPool::set_mode(ParallelMode mode)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+
+    m_mode = mode;
+    for (auto& t : m_threads)
+        t->tree.set_abdada_table(m_mode == ParallelMode::ABDADA ? &m_abdada : nullptr);
+}
+
+void SearchThreadPool::set_pruning(const PruningParams& params)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+
+    m_pruning = params;
+    for (auto& t : m_threads)
+        t->tree.set_pruning(m_pruning);
+}
+
+void SearchThreadPool::thread_loop(unsigned idx, uint64_t generation)
+{
+    uint64_t seen_generation = generation;
+    SearchThread& st = *m_threads[idx];
+
+    while (true)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_start_cv.wait(lock, [&] { return m_quit || m_generation != seen_generation; });
+            if (m_quit)
+                return;
+            seen_generation = m_generation;
+        }
+
+        if (idx == 0)
+        {
+            m_result = st.tree.search(m_limits, m_colour, m_think_cb);
+
+            // The main thread decides when the search is over.
+            m_stop = true;
+        }
+        else
+        {
+            st.tree.run_worker(m_limits, idx);
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (--m_running == 0)
+                m_done_cv.notify_all();
+        }
+    }
+}
+
+void SearchThreadPool::start_search(const BitBoard& board, const SearchLimits& limits, PieceColour ai_colour,
+                                    ThinkCallback think_cb, bool ponder)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+
+    for (auto& t : m_threads)
+    {
+        t->board = board;
+        t->board.set_network(m_network);
+        t->tree.set_history(m_history);
+    }
+
+    m_limits = limits;
+    m_colour = ai_colour;
+    // Progress is reported by the main thread, but the node count covers the whole pool.
+    m_think_cb = nullptr;
+    if (think_cb)
+    {
+        m_think_cb = [this, think_cb = std::move(think_cb)](uint8_t depth, int score_cp, int elapsed_cs, uint64_t,
+                                                            const std::string& pv, uint8_t pv_index) {
+            think_cb(depth, score_cp, elapsed_cs, nodes_searched(), pv, pv_index);
+        };
+    }
+    m_stop = false;
+    m_ponder.pondering = ponder;
+
+    m_running = size();
+    ++m_generation;
+
+    lock.unlock();
+    m_start_cv.notify_all();
+}
+
+void SearchThreadPool::set_history(const PositionHistory& history)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+    m_history = history;
+}
+
+Move SearchThreadPool::wait_for_result()
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+    return select_best_move();
+}
+
+void SearchThreadPool::ponder_hit(const SearchLimits& limits)
+{
+    // Threads only read hit_limits after seeing the flag cleared.
+    m_ponder.hit_limits = limits;
+    m_ponder.pondering.store(false, std::memory_order_release);
+}
+
+bool SearchThreadPool::is_searching()
+{
+    std::lock_guard lock(m_mutex);
+    return m_running != 0;
+}
+
+std::optional<Move> SearchThreadPool::hash_move(const BitBoard& board) const
+{
+    uint64_t hash = m_hasher.get_hash(board);
+    const TTEntry& e = m_tt->entry(hash);
+    if (e.flag == TTEntry::Flag::EMPTY || e.key != hash || !e.best_move.is_valid())
+        return std::nullopt;
+
+    // The TT is written without locks, so check the move really belongs to this position.
+    BitBoard copy(board);
+    for (const auto& move : copy.get_all_legal_moves(copy.get_colour_to_move()))
+    {
+        if (move == e.best_move)
+            return move;
+    }
+    return std::nullopt;
+}
+
+Move SearchThreadPool::select_best_move() const
+{
+    const SearchResult& main_result = m_threads[0]->tree.get_result();
+    if (main_result.depth == 0)
+        return m_result;
+
+    std::vector<SearchResult> results;
+    for (const auto& t : m_threads)
+        results.push_back(t->tree.get_result());
+    return vote_best_move(results);
+}
+
+Move SearchThreadPool::vote_best_move(const std::vector<SearchResult>& results)
+{
+    const SearchResult& main_result = results[0];
+
+    // A proven mate wins outright, the shortest first and then the deepest search.
+    const SearchResult* mate = nullptr;
+    for (const auto& r : results)
+    {
+        if (r.depth > 0 && r.score >= MATE_THRESHOLD &&
+            (!mate || r.score > mate->score || (r.score == mate->score && r.depth > mate->depth)))
+            mate = &r;
+    }
+    if (mate)
+        return mate->best_move;
+
+    // Otherwise each thread that did at least as well as the main thread votes for its move,
+    // weighted by its completed depth and by how much its score beats the main thread's. The score
+    // margin is capped so one helper's shallow result can't outweigh all the others.
+    std::vector<std::pair<Move, float>> votes;
+    for (const auto& r : results)
+    {
+        if (r.depth == 0 || r.score < main_result.score)
+            continue;
+
+        float weight = (std::min(r.score - main_result.score, MAX_VOTE_MARGIN) + 0.1f) * r.depth;
+        auto it = std::find_if(votes.begin(), votes.end(), [&](const auto& v) { return v.first == r.best_move; });
+        if (it == votes.end())
+            votes.emplace_back(r.best_move, weight);
+        else
+            it->second += weight;
+    }
+
+    auto best = std::find_if(votes.begin(), votes.end(), [&](const auto& v) { return v.first == main_result.best_move; });
+    for (auto it = votes.begin(); it != votes.end(); ++it)
+    {
+        if (it->second > best->second)
+            best = it;
+    }
+
+    return best->first;
+}
+
+uint64_t SearchThreadPool::nodes_searched() const
+{
+    uint64_t nodes = 0;
+    for (const auto& t : m_threads)
+        nodes += t->tree.get_nodes();
+    return nodes;
+}
+
+HashStats SearchThreadPool::pawn_hash_stats() const
+{
+    HashStats stats;
+    for (const auto& t : m_threads)
+        stats += t->tree.get_pawn_hash_stats();
+    return stats;
+}
+
+HashStats SearchThreadPool::material_hash_stats() const
+{
+    HashStats stats;
+    for (const auto& t : m_threads)
+        stats += t->tree.get_material_hash_stats();
+    return stats;
+}
+
+HashStats SearchThreadPool::eval_cache_stats() const
+{
+    HashStats stats;
+    for (const auto& t : m_threads)
+        stats += t->tree.get_eval_cache_stats();
+    return stats;
+}
+
+EvalStats SearchThreadPool::eval_stats() const
+{
+    EvalStats stats;
+    for (const auto& t : m_threads)
+        stats += t->tree.get_eval_stats();
+    return stats;
+}
+
+void SearchThreadPool::set_network(std::shared_ptr<const nnue::Network> network)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+
+    // Evaluations cached so far, and TT scores built on them, came from the old evaluation.
+    m_network = std::move(network);
+    for (auto& t : m_threads)
+        t->tree.clear_eval_cache();
+    m_tt->clear();
+}
+
+void SearchThreadPool::clear_hash()
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+    m_tt->clear();
+    m_abdada.clear();
+}
+
+void SearchThreadPool::set_hash_size(size_t size_mb)
+{
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_running == 0; });
+    m_tt->resize(size_mb);
+}
+
+void SearchThreadPool::stop()
+{
+    m_stop = true;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "abdada_table.h"
+#include "bitboards/bitboard.h"
+#include "search_tree.h"
+#include "time_manager.h"
+#include "zobrist_hash.h"
+
+enum class ParallelMode {
+    LAZY_SMP,   // independent threads sharing only the TT
+    ABDADA,     // threads defer moves that another thread is already searching
+};
+
+// Long-lived parallel search threads. Thread 0 runs the main iterative deepening search and the
+// others are helpers sharing its transposition table. Each thread keeps its own board and
+// SearchTree (killers, node counts) between moves, and sleeps on a condition variable when idle.
+class SearchThreadPool
+{
+private:
+    struct SearchThread
+    {
+        BitBoard board;
+        SearchTree tree;
+        std::thread thread;
+
+        SearchThread(TranspositionTable& tt, const ZobristHash& hasher, const std::atomic<bool>& stop,
+                     const PonderControl& ponder) :
+            tree(board, tt, hasher, stop, ponder)
+        {}
+    };
+
+    // Shared by all threads: the hash keys must agree for TT entries to be useful to each other.
+    ZobristHash m_hasher;
+    std::unique_ptr<TranspositionTable> m_tt;
+    AbdadaTable m_abdada;
+    ParallelMode m_mode = ParallelMode::LAZY_SMP;
+    PruningParams m_pruning;
+    std::shared_ptr<const nnue::Network> m_network;
+
+    std::vector<std::unique_ptr<SearchThread>> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start_cv;
+    std::condition_variable m_done_cv;
+    uint64_t m_generation = 0;
+    unsigned m_running = 0;
+    bool m_quit = false;
+
+    std::atomic<bool> m_stop = false;
+    PonderControl m_ponder;
+
+    // Current search job, written only while all threads are idle
+    SearchLimits m_limits;
+    PieceColour m_colour = PieceColour::WHITE;
+    PositionHistory m_history;
+    ThinkCallback m_think_cb;
+    Move m_result;
+
+    // Most a helper's score can beat the main thread's by and still count towards its vote, in pawns
+    static constexpr float MAX_VOTE_MARGIN = 1.f;
+
+    void thread_loop(unsigned idx, uint64_t generation);
+    Move select_best_move() const;
+    void start_threads(unsigned n_threads);
+    void stop_threads();
+
+public:
+    SearchThreadPool(unsigned n_threads);
+    ~SearchThreadPool();
+
+    SearchThreadPool(const SearchThreadPool&) = delete;
+    SearchThreadPool& operator=(const SearchThreadPool&) = delete;
+
+    //! Wake all threads to search a copy of the given position
+    /*!
+     * \param ponder if true, ignore the limits until ponder_hit() supplies the real ones
+     */
+    void start_search(const BitBoard& board, const SearchLimits& limits, PieceColour ai_colour,
+                      ThinkCallback think_cb = nullptr, bool ponder = false);
+
+    //! Set the game positions leading to the next searched position, which should be the last
+    /*!
+     * Waits for any running search to finish first.
+     */
+    void set_history(const PositionHistory& history);
+
+    //! Turn a pondering search into a normal one, keeping its TT and iteration state
+    /*!
+     * Collect the move with wait_for_result() as usual.
+     */
+    void ponder_hit(const SearchLimits& limits);
+
+    //! Whether any thread is still working on the last search
+    bool is_searching();
+
+    //! Best move stored in the transposition table for this position, if it is legal there
+    std::optional<Move> hash_move(const BitBoard& board) const;
+
+    //! Block until the main thread has finished and all helpers are idle again
+    /*!
+     * \return the best move, voted for by all threads according to their completed depth and score
+     */
+    Move wait_for_result();
+
+    //! Choose between the threads' completed searches, the main thread's first
+    /*!
+     * A proven mate wins outright. Otherwise the threads scoring at least as well as the main
+     * thread vote for their moves by completed depth and score, and the main thread's move wins ties.
+     */
+    static Move vote_best_move(const std::vector<SearchResult>& results);
+
+    //! Ask all threads to abandon the current search as soon as possible
+    void stop();
+
+    //! Change the number of search threads, waiting for any running search to finish first
+    void resize(unsigned n_threads);
+
+    //! Switch between Lazy SMP and ABDADA, waiting for any running search to finish first
+    void set_mode(ParallelMode mode);
+    ParallelMode get_mode() const { return m_mode; }
+
+    //! Change the selective pruning settings, waiting for any running search to finish first
+    void set_pruning(const PruningParams& params);
+    const PruningParams& get_pruning() const { return m_pruning; }
+
+    //! Evaluate with a neural network, or with ShannonHeuristic if nullptr
+    /*!
+     * Waits for any running search to finish first.
+     */
+    void set_network(std::shared_ptr<const nnue::Network> network);
+
+    //! Clear the transposition table, waiting for any running search to finish first
+    void clear_hash();
+
+    //! Resize the transposition table, waiting for any running search to finish first
+    void set_hash_size(size_t size_mb);
+
+    //! Permille of the transposition table in use
+    int hashfull() const { return m_tt->hashfull(); }
+
+    //! Total nodes searched by all threads in the last search
+    uint64_t nodes_searched() const;
+
+    //! Pawn hash table lookups of all threads in the last search
+    HashStats pawn_hash_stats() const;
+
+    //! Material table lookups of all threads in the last search
+    HashStats material_hash_stats() const;
+
+    //! Evaluation cache lookups of all threads in the last search
+    HashStats eval_cache_stats() const;
+
+    //! Evaluations made by all threads in the last search, and how many stopped early
+    EvalStats eval_stats() const;
+
+    const ZobristHash& get_hasher() const { return m_hasher; }
+
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+};
@@ -1,11 +1,86 @@
 #include "search_tree.h"
+#include "heuristic.h"
 #include <vector>
 #include <limits>
 #include <algorithm>
-#include <thread>
+#include <cmath>
+#include <cstdlib>
 
 static constexpr float ASPIRATION_WINDOW = 0.5f;
 
+// How often (in nodes) the hard deadline is polled.
+static constexpr uint64_t TIME_CHECK_INTERVAL = 1024;
+
+// Don't start a new iteration after this fraction of the scaled soft limit has gone,
+// as it is unlikely to finish in time.
+static constexpr float NEW_ITERATION_FRACTION = 0.6f;
+
+// Positional gain allowed on top of the captured piece before delta pruning drops a capture.
+static constexpr float DELTA_MARGIN = 2.f;
+
+// Below this depth, nodes are too cheap for ABDADA move deferral to pay for its table traffic.
+static constexpr uint8_t ABDADA_MIN_DEPTH = 3;
+
+// Scale the soft time limit by how settled the root looks: spend longer while the best move
+// keeps changing or the score is falling, and stop early once one move is clearly best.
+static float soft_time_scale(int stable_count, float score_drop)
+{
+    float scale = 1.0f;
+
+    if (stable_count == 0)       scale = 1.6f;
+    else if (stable_count == 1)  scale = 1.2f;
+    else if (stable_count >= 3)  scale = 0.4f;
+
+    if (score_drop > 1.0f)       scale *= 2.5f;
+    else if (score_drop > 0.3f)  scale *= 1.5f;
+
+    return scale;
+}
+
+// Mate scores in the TT are relative to the node, not the root, so they stay valid wherever
+// the position is reached.
+static float score_to_tt(float score, uint8_t ply)
+{
+    if (score >= MATE_THRESHOLD)  return score + ply;
+    if (score <= -MATE_THRESHOLD) return score - ply;
+    return score;
+}
+
+static float score_from_tt(float score, uint8_t ply)
+{
+    if (score >= MATE_THRESHOLD)  return score - ply;
+    if (score <= -MATE_THRESHOLD) return score + ply;
+    return score;
+}
+
+// A TT bound from any depth is a better guess than the static evaluation when it lies on the
+// side it bounds, e.g. an upper bound below it for a side about to be mated.
+static float refine_eval(float static_eval, const TTEntry& e, uint64_t hash, uint8_t ply)
+{
+    if (e.flag == TTEntry::Flag::EMPTY || e.key != hash)
+        return static_eval;
+
+    float tt_score = score_from_tt(e.score, ply);
+    if ((e.flag != TTEntry::Flag::UPPER_BOUND && tt_score > static_eval)
+        || (e.flag != TTEntry::Flag::LOWER_BOUND && tt_score < static_eval))
+    {
+        return tt_score;
+    }
+    return static_eval;
+}
+
+std::optional<int> mate_in_moves(int score_cp)
+{
+    const int mate_cp = static_cast<int>(MATE_SCORE * 100.f);
+    const int threshold_cp = static_cast<int>(MATE_THRESHOLD * 100.f);
+    if (std::abs(score_cp) < threshold_cp)
+        return std::nullopt;
+
+    int plies = (mate_cp - std::abs(score_cp) + 50) / 100;
+    int moves = (plies + 1) / 2;
+    return score_cp > 0 ? moves : -moves;
+}
+
 static int piece_value(PieceType pt)
 {
     switch (pt) {
@@ -47,15 +122,117 @@ static int move_score(const BitBoard& board, const Move& move)
     return score;
 }
 
-float SearchTree::quiescence(float alpha, float beta)
+bool SearchTree::pondering()
 {
-    ++m_nodes;
+    if (m_pondering && !m_ponder.pondering.load(std::memory_order_acquire))
+    {
+        // Ponder hit: hit_limits was written before the flag was cleared.
+        m_limits = m_ponder.hit_limits;
+        m_pondering = false;
+    }
+    return m_pondering;
+}
 
-    float stand_pat = ShannonHeuristic(m_board, m_board.get_colour_to_move()).get();
-    if (stand_pat >= beta) return beta;
-    if (stand_pat > alpha) alpha = stand_pat;
+// The history must end at the root for keys further back to be comparable.
+void SearchTree::start_history()
+{
+    uint64_t root_key = hasher.get_hash(m_board);
+    if (m_history.empty() || m_history.key() != root_key)
+        m_history.reset(root_key);
+}
 
-    BitBoard::MoveList move_list = m_board.get_all_legal_moves(m_board.get_colour_to_move());
+bool SearchTree::limit_reached() const
+{
+    if (m_limits.infinite)
+        return false;
+
+    return std::chrono::steady_clock::now() >= m_limits.hard_deadline
+        || (m_limits.max_nodes && m_nodes >= *m_limits.max_nodes);
+}
+
+bool SearchTree::out_of_time()
+{
+    if (!m_aborted && (m_nodes % TIME_CHECK_INTERVAL) == 0
+        && (m_stop.load(std::memory_order_relaxed) || (!pondering() && limit_reached())))
+    {
+        m_aborted = true;
+    }
+    return m_aborted;
+}
+
+// Static evaluation of the current position for the side to move, given its hash, by the board's
+// network if it has one. ShannonHeuristic's evaluation may be only a bound outside the window
+// (alpha, beta), which isn't cached.
+float SearchTree::evaluate(uint64_t hash, float alpha, float beta)
+{
+    float score;
+    if (m_eval_cache.probe(hash, score))
+        return score;
+
+    ++m_eval_stats.calls;
+    if (const nnue::Accumulator* accumulator = m_board.get_accumulator())
+    {
+        score = accumulator->evaluate(m_board.get_colour_to_move() == PieceColour::WHITE) / 100.0f;
+        m_eval_cache.store(hash, score);
+        return score;
+    }
+
+    ShannonHeuristic eval(m_board, m_board.get_colour_to_move(), alpha, beta, &m_eval_tables);
+    if (eval.is_lazy())
+        ++m_eval_stats.lazy_exits;
+    else
+        m_eval_cache.store(hash, eval.get());
+    return eval.get();
+}
+
+float SearchTree::quiescence(float alpha, float beta, uint8_t ply)
+{
+    m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (out_of_time()) return 0.f;
+
+    const PieceColour to_move = m_board.get_colour_to_move();
+
+    const uint64_t hash = hasher.get_hash(m_board);
+
+    // Quiet evasions that give check can answer each other indefinitely, so stop somewhere.
+    if (ply >= MAX_MATE_PLY)
+        return evaluate(hash);
+
+    TTEntry& e = m_tt.entry(hash);
+    if (e.flag != TTEntry::Flag::EMPTY && e.key == hash) {
+        float tt_score = score_from_tt(e.score, ply);
+        if (e.flag == TTEntry::Flag::EXACT)                           return tt_score;
+        if (e.flag == TTEntry::Flag::LOWER_BOUND && tt_score >= beta)  return tt_score;
+        if (e.flag == TTEntry::Flag::UPPER_BOUND && tt_score <= alpha) return tt_score;
+    }
+
+    // Quiescence results are the least valuable in the table, so they never replace a deeper entry.
+    auto store = [&](float score, const Move& move, TTEntry::Flag flag) {
+        if (e.flag == TTEntry::Flag::EMPTY || e.depth == 0)
+            e = { hash, move, score_to_tt(score, ply), 0, flag };
+    };
+
+    // Generating the moves also finds the attacks that get_in_check() reads.
+    BitBoard::MoveList move_list = m_board.get_all_legal_moves(to_move);
+    const bool in_check = m_board.get_in_check(to_move);
+    if (move_list.empty())
+        return in_check ? -MATE_SCORE + ply : 0.f;
+
+    // In check there is no standing pat: every evasion is searched, not just captures.
+    float stand_pat = -MATE_SCORE + ply;
+    if (!in_check)
+    {
+        stand_pat = refine_eval(evaluate(hash, alpha, beta), e, hash, ply);
+        if (stand_pat >= beta)
+        {
+            store(stand_pat, Move(), TTEntry::Flag::LOWER_BOUND);
+            return beta;
+        }
+    }
+
+    const float original_alpha = alpha;
+    if (stand_pat > alpha) alpha = stand_pat;
+    Move best_move;
 
     std::sort(move_list.begin(), move_list.end(), [&](const Move& a, const Move& b) {
         return move_score(m_board, a) > move_score(m_board, b);
@@ -63,45 +240,109 @@ float SearchTree::quiescence(float alpha, float beta)
 
     for (const auto& move : move_list)
     {
-        if (!move.get_captured_piece_type().has_value() && !move.is_en_passant_capture())
-            continue;
+        if (!in_check)
+        {
+            auto captured = move.get_captured_piece_type();
+            if (!captured.has_value() && !move.is_en_passant_capture())
+                continue;
+
+            // Delta pruning: even winning the piece outright, with a margin for positional
+            // gains, doesn't reach alpha. Promotions gain more than the capture, so always try them.
+            const int victim = captured.has_value() ? piece_value(*captured) : 1;
+            if (!move.get_promotion_type().has_value() && stand_pat + victim + DELTA_MARGIN <= alpha)
+                continue;
+
+            // Captures that lose material can't raise alpha from the stand-pat score.
+            if (!m_board.see_ge(move, 0))
+                continue;
+        }
 
         m_board.make_move(move);
-        float score = -quiescence(-beta, -alpha);
+        float score = -quiescence(-beta, -alpha, ply + 1);
         m_board.unmake_move(move);
 
-        if (score >= beta) return beta;
-        if (score > alpha) alpha = score;
+        if (m_aborted) return 0.f;
+
+        if (score >= beta)
+        {
+            store(beta, move, TTEntry::Flag::LOWER_BOUND);
+            return beta;
+        }
+        if (score > alpha)
+        {
+            alpha = score;
+            best_move = move;
+        }
     }
 
+    store(alpha, best_move, alpha > original_alpha ? TTEntry::Flag::EXACT : TTEntry::Flag::UPPER_BOUND);
     return alpha;
 }
 
 float SearchTree::negamax(float alpha, float beta, uint8_t depth_left, bool null_move_ok, uint8_t ply)
 {
-    ++m_nodes;
-    uint64_t hash = hasher->get_hash(m_board);
+    m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (out_of_time()) return 0.f;
+
+    // Never the root, so a repeated position or fifty moves without progress is a draw.
+    if (m_history.is_repetition() || m_history.is_fifty_move_draw())
+        return 0.f;
+
+    // Mate distance pruning: even mating here can't beat a shorter mate found elsewhere.
+    alpha = std::max(alpha, -MATE_SCORE + ply);
+    beta  = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta) return alpha;
 
-    const auto& e = m_tt[hash & (TT_SIZE - 1)];
+    uint64_t hash = m_history.key();
+
+    const auto& e = m_tt.entry(hash);
     if (e.flag != TTEntry::Flag::EMPTY && e.key == hash && e.depth >= depth_left) {
-        if (e.flag == TTEntry::Flag::EXACT)                          return e.score;
-        if (e.flag == TTEntry::Flag::LOWER_BOUND && e.score > alpha) alpha = e.score;
-        if (e.flag == TTEntry::Flag::UPPER_BOUND && e.score < beta)  beta  = e.score;
-        if (alpha >= beta) return e.score;
+        float tt_score = score_from_tt(e.score, ply);
+        if (e.flag == TTEntry::Flag::EXACT)                           return tt_score;
+        if (e.flag == TTEntry::Flag::LOWER_BOUND && tt_score > alpha) alpha = tt_score;
+        if (e.flag == TTEntry::Flag::UPPER_BOUND && tt_score < beta)  beta  = tt_score;
+        if (alpha >= beta) return tt_score;
     }
 
     if (depth_left == 0)
-        return quiescence(alpha, beta);
+        return quiescence(alpha, beta, ply);
 
     BitBoard::MoveList move_list = m_board.get_all_legal_moves(m_board.get_colour_to_move());
 
     if (move_list.empty())
     {
-        return m_board.get_in_check(m_board.get_colour_to_move()) ? -200.f : 0.f;
+        return m_board.get_in_check(m_board.get_colour_to_move()) ? -MATE_SCORE + ply : 0.f;
     }
 
     bool in_check = m_board.get_in_check(m_board.get_colour_to_move());
 
+    // Selective pruning near the leaves, all based on the static evaluation. Never in check,
+    // where the static evaluation means little.
+    const PruningParams& prune = m_pruning;
+    const int max_prune_depth = std::max({ prune.reverse_futility ? prune.reverse_futility_depth : 0,
+                                         prune.futility ? prune.futility_depth : 0,
+                                         prune.razoring ? prune.razor_depth : 0,
+                                         prune.late_move_pruning ? prune.late_move_depth : 0 });
+    const bool can_prune = !in_check && depth_left <= max_prune_depth;
+    const float static_eval = can_prune ?
+        refine_eval(evaluate(hash), e, hash, ply) : 0.f;
+
+    // Reverse futility: so far above beta that losing a margin per ply still leaves us above it.
+    if (can_prune && prune.reverse_futility && depth_left <= prune.reverse_futility_depth && beta < MATE_THRESHOLD
+        && static_eval - prune.reverse_futility_margin / 100.f * depth_left >= beta)
+    {
+        return beta;
+    }
+
+    // Razoring: so far below alpha that only tactics could help, which quiescence will find.
+    if (can_prune && prune.razoring && depth_left <= prune.razor_depth
+        && static_eval + prune.razor_margin / 100.f * depth_left <= alpha)
+    {
+        float q_score = quiescence(alpha, beta, ply);
+        if (m_aborted) return 0.f;
+        if (q_score <= alpha) return alpha;
+    }
+
     // Null move pruning: skip our turn and see if the opponent can still beat beta.
     // Skip when in check (illegal) or in pawn-only positions (risk of zugzwang).
     static constexpr int NULL_MOVE_REDUCTION = 2;
@@ -116,17 +357,25 @@ float SearchTree::negamax(float alpha, float beta, uint8_t depth_left, bool null
             auto saved_ep = m_board.get_enpassant_column();
             m_board.set_enpassant_column(std::nullopt);
             m_board.set_colour_to_move(us == PieceColour::WHITE ? PieceColour::BLACK : PieceColour::WHITE);
+            // A null move can't be part of a repetition, so it breaks the chain like a capture.
+            m_history.push(hasher.get_hash(m_board), true);
 
             float null_score = -negamax(-beta, -beta + 1.f, depth_left - NULL_MOVE_REDUCTION - 1, false, ply + 1);
 
+            m_history.pop();
             m_board.set_colour_to_move(us);
             m_board.set_enpassant_column(saved_ep);
 
+            if (m_aborted) return 0.f;
+
             if (null_score >= beta)
                 return beta;
         }
     }
 
+    // Captures losing material by static exchange go after the quiet moves.
+    static constexpr int BAD_CAPTURE_PENALTY = 1000;
+
     const auto& killers = m_killers[ply];
     auto score_move = [&](const Move& m) {
         int s = move_score(m_board, m);
@@ -134,21 +383,51 @@ float SearchTree::negamax(float alpha, float beta, uint8_t depth_left, bool null
             if (m == killers[0])      s += 9;
             else if (m == killers[1]) s += 8;
         }
+        else if (!m_board.see_ge(m, 0)) {
+            s -= BAD_CAPTURE_PENALTY;
+        }
         return s;
     };
-    std::sort(move_list.begin(), move_list.end(), [&](const Move& a, const Move& b) {
-        return score_move(a) > score_move(b);
+
+    // Score each move once, as SEE is too costly to repeat in every comparison.
+    boost::container::static_vector<std::pair<int, Move>, 256> scored_moves;
+    for (const auto& move : move_list)
+        scored_moves.emplace_back(score_move(move), move);
+    std::stable_sort(scored_moves.begin(), scored_moves.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
     });
+    for (size_t i = 0; i < scored_moves.size(); ++i)
+        move_list[i] = scored_moves[i].second;
 
     float original_alpha = alpha;
     Move best_move;
 
-    for (const auto& move : move_list)
-    {
+    // Futility and late move pruning skip quiet moves, other than checks, once the first move has been searched:
+    // near the leaves a quiet move can't lift a hopeless position to alpha, and quiet moves
+    // sorted late rarely beat the earlier ones. Not while being mated, to find the longest defence.
+    const bool prune_quiets = can_prune && alpha > -MATE_THRESHOLD;
+    const bool futile = prune_quiets && prune.futility && depth_left <= prune.futility_depth
+        && static_eval + prune.futility_margin / 100.f * depth_left <= alpha;
+    const int late_move_limit = prune_quiets && prune.late_move_pruning && depth_left <= prune.late_move_depth ?
+        prune.late_move_count + depth_left * depth_left : std::numeric_limits<int>::max();
+    int quiet_moves = 0;
+
+    // Returns true on a beta cutoff. move_key is non-zero if the move should be announced to
+    // other ABDADA threads while it is searched.
+    auto search_move = [&](const Move& move, uint64_t move_key) {
+        if (move_key) m_abdada->start_search(move_key);
+
+        bool resets_clock = PositionHistory::resets_clock(m_board, move);
         m_board.make_move(move);
+        m_history.push(hasher.get_hash(m_board), resets_clock);
         float score = -negamax(-beta, -alpha, depth_left - 1, true, ply + 1);
+        m_history.pop();
         m_board.unmake_move(move);
 
+        if (move_key) m_abdada->finish_search(move_key);
+
+        if (m_aborted) return false;
+
         if (score >= beta)
         {
             if (!move.get_captured_piece_type().has_value() && !move.is_en_passant_capture()
@@ -159,18 +438,55 @@ float SearchTree::negamax(float alpha, float beta, uint8_t depth_left, bool null
                     m_killers[ply][0] = move;
                 }
             }
-            m_tt[hash & (TT_SIZE - 1)] = { hash, move, beta, depth_left, TTEntry::Flag::LOWER_BOUND };
-            return beta;
+            m_tt.entry(hash) = { hash, move, score_to_tt(beta, ply), depth_left, TTEntry::Flag::LOWER_BOUND };
+            return true;
         }
         if (score > alpha)
         {
             alpha = score;
             best_move = move;
         }
+        return false;
+    };
+
+    // ABDADA: the first move is always searched, as it is what makes the node worth splitting.
+    // Later moves that another thread is already searching are deferred to the end, by which
+    // time their result is likely to be in the TT.
+    const bool share_work = m_abdada && depth_left >= ABDADA_MIN_DEPTH;
+    BitBoard::MoveList deferred;
+
+    for (size_t i = 0; i < move_list.size(); ++i)
+    {
+        const Move& move = move_list[i];
+
+        if (!move.get_captured_piece_type().has_value() && !move.is_en_passant_capture()
+            && !move.get_promotion_type().has_value())
+        {
+            ++quiet_moves;
+            if (i > 0 && (futile || quiet_moves > late_move_limit) && !m_board.gives_check(move))
+                continue;
+        }
+
+        uint64_t move_key = share_work ? AbdadaTable::move_key(hash, move) : 0;
+
+        if (move_key && i > 0 && m_abdada->is_searching(move_key))
+        {
+            deferred.push_back(move);
+            continue;
+        }
+
+        if (search_move(move, move_key)) return beta;
+        if (m_aborted) return 0.f;
+    }
+
+    for (const auto& move : deferred)
+    {
+        if (search_move(move, 0)) return beta;
+        if (m_aborted) return 0.f;
     }
 
     TTEntry::Flag flag = (alpha <= original_alpha) ? TTEntry::Flag::UPPER_BOUND : TTEntry::Flag::EXACT;
-    m_tt[hash & (TT_SIZE - 1)] = { hash, best_move, alpha, depth_left, flag };
+    m_tt.entry(hash) = { hash, best_move, score_to_tt(alpha, ply), depth_left, flag };
 
     return alpha;
 }
@@ -183,8 +499,8 @@ std::string SearchTree::extract_principal_variation(const Move& first_move, int
 
     for (int i = 1; i < depth; ++i)
     {
-        uint64_t hash = hasher->get_hash(board);
-        const auto& e = m_tt[hash & (TT_SIZE - 1)];
+        uint64_t hash = hasher.get_hash(board);
+        const auto& e = m_tt.entry(hash);
         if (e.flag == TTEntry::Flag::EMPTY || e.key != hash || !e.best_move.is_valid())
             break;
 
@@ -196,8 +512,71 @@ std::string SearchTree::extract_principal_variation(const Move& first_move, int
     return line;
 }
 
-void SearchTree::run_worker(std::chrono::steady_clock::time_point deadline)
+float SearchTree::search_root(const BitBoard::MoveList& root_moves, float alpha, float beta, uint8_t depth,
+                              size_t& best_idx)
+{
+    float best_score = -std::numeric_limits<float>::infinity();
+
+    for (size_t i = 0; i < root_moves.size(); ++i)
+    {
+        bool resets_clock = PositionHistory::resets_clock(m_board, root_moves[i]);
+        m_board.make_move(root_moves[i]);
+        m_history.push(hasher.get_hash(m_board), resets_clock);
+        float score = -negamax(-beta, -alpha, depth, true, 1);
+        m_history.pop();
+        m_board.unmake_move(root_moves[i]);
+
+        if (m_aborted) break;
+
+        if (score > best_score) { best_score = score; best_idx = i; }
+        if (score > alpha)      alpha      = score;
+    }
+
+    return best_score;
+}
+
+void SearchTree::search_other_lines(BitBoard::MoveList root_moves, uint8_t depth, std::vector<SearchResult>& lines)
 {
+    const float INF = std::numeric_limits<float>::infinity();
+
+    while (lines.size() < m_limits.multi_pv)
+    {
+        // Exclude the moves already found, so the search returns the next best one.
+        const Move& found = lines.back().best_move;
+        root_moves.erase(std::remove(root_moves.begin(), root_moves.end(), found), root_moves.end());
+        if (root_moves.empty())
+            break;
+
+        // Full window: the score of each line is reported, not just its order.
+        size_t best_idx  = 0;
+        float best_score = search_root(root_moves, -INF, INF, depth, best_idx);
+        if (m_aborted)
+            break;
+
+        lines.push_back({ root_moves[best_idx], best_score, depth });
+    }
+
+    // Scores from separate searches of a shared TT aren't always consistent, so order the extra
+    // lines by score. The best line stays first: it is the one the search acts on.
+    std::stable_sort(lines.begin() + 1, lines.end(), [](const SearchResult& a, const SearchResult& b) {
+        return a.score > b.score;
+    });
+}
+
+void SearchTree::run_worker(const SearchLimits& limits, unsigned thread_idx)
+{
+    m_nodes = 0;
+    m_eval_tables.pawns.reset_stats();
+    m_eval_tables.material.reset_stats();
+    m_eval_cache.reset_stats();
+    m_eval_stats = {};
+    m_killers = {};
+    m_limits = limits;
+    m_pondering = m_ponder.pondering.load(std::memory_order_acquire);
+    m_aborted = false;
+    m_result = {};
+    start_history();
+
     BitBoard::MoveList root_moves = m_board.get_all_legal_moves(m_board.get_colour_to_move());
     if (root_moves.size() <= 1) return;
 
@@ -205,29 +584,38 @@ void SearchTree::run_worker(std::chrono::steady_clock::time_point deadline)
         return move_score(m_board, a) > move_score(m_board, b);
     });
 
+    // Diversify Lazy SMP helpers so they don't duplicate the main thread: each one searches the
+    // root moves after the first in a rotated order, and skips a thread-dependent set of depths.
+    // ABDADA helpers follow the main thread's order and depths, and split work inside the tree.
+    if (!m_abdada && root_moves.size() > 2)
+    {
+        size_t shift = thread_idx % (root_moves.size() - 1);
+        std::rotate(root_moves.begin() + 1, root_moves.begin() + 1 + shift, root_moves.end());
+    }
+
+    static constexpr int SKIP_SIZE[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    static constexpr int SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    const size_t skip_idx = (thread_idx - 1) % std::size(SKIP_SIZE);
+
     float prev_score = 0.0f;
     const float INF  = std::numeric_limits<float>::infinity();
 
     for (uint8_t depth = 1; depth <= MAX_DEPTH; ++depth)
     {
-        float delta = (depth <= 2) ? INF : ASPIRATION_WINDOW;
-        float alpha = (depth <= 2) ? -INF : prev_score - delta;
-        float beta  = (depth <= 2) ?  INF : prev_score + delta;
+        if (!m_abdada && ((depth + SKIP_PHASE[skip_idx]) / SKIP_SIZE[skip_idx]) % 2)
+            continue;
+
+        // Full window until this thread has a score of its own to centre on.
+        bool full_window = depth <= 2 || m_result.depth == 0;
+        float delta = full_window ? INF : ASPIRATION_WINDOW;
+        float alpha = full_window ? -INF : prev_score - delta;
+        float beta  = full_window ?  INF : prev_score + delta;
 
         while (true)
         {
-            float cur_alpha  = alpha;
-            float best_score = -INF;
-
-            for (const auto& move : root_moves)
-            {
-                if (std::chrono::steady_clock::now() >= deadline) return;
-                m_board.make_move(move);
-                float score = -negamax(-beta, -cur_alpha, depth, true, 1);
-                m_board.unmake_move(move);
-                if (score > best_score) best_score = score;
-                if (score > cur_alpha)  cur_alpha   = score;
-            }
+            size_t best_idx  = 0;
+            float best_score = search_root(root_moves, alpha, beta, depth, best_idx);
+            if (m_aborted) return;
 
             if (best_score <= alpha)
             {
@@ -242,43 +630,62 @@ void SearchTree::run_worker(std::chrono::steady_clock::time_point deadline)
             else
             {
                 prev_score = best_score;
+
+                // Search this thread's best move first in its next iteration.
+                std::rotate(root_moves.begin(), root_moves.begin() + best_idx, root_moves.begin() + best_idx + 1);
+                m_result = { root_moves.front(), best_score, depth };
                 break;
             }
 
             if (delta > 4.0f) { alpha = -INF; beta = INF; delta = INF; }
         }
 
-        if (std::chrono::steady_clock::now() >= deadline) return;
+        // Helpers search the extra lines too, so the main thread finds them in the TT.
+        if (m_limits.multi_pv > 1)
+        {
+            std::vector<SearchResult> lines = { m_result };
+            search_other_lines(root_moves, depth, lines);
+            if (m_aborted) return;
+        }
+
+        if (m_stop.load(std::memory_order_relaxed)
+            || (!pondering() && limit_reached())) return;
     }
 }
 
-Move SearchTree::search(std::chrono::steady_clock::time_point deadline, PieceColour ai_colour,
+Move SearchTree::search(const SearchLimits& limits, PieceColour ai_colour,
                         ThinkCallback think_cb)
 {
     m_nodes = 0;
+    m_eval_tables.pawns.reset_stats();
+    m_eval_tables.material.reset_stats();
+    m_eval_cache.reset_stats();
+    m_eval_stats = {};
     m_killers = {};
-    auto search_start = std::chrono::steady_clock::now();
+    m_limits = limits;
+    m_pondering = m_ponder.pondering.load(std::memory_order_acquire);
+    m_aborted = false;
+    m_result = {};
+    start_history();
+    auto search_start = m_limits.start;
 
     BitBoard::MoveList root_moves = m_board.get_all_legal_moves(m_board.get_colour_to_move());
 
+    // Checkmate or stalemate: nothing to search.
+    if (root_moves.empty())
+        return Move();
+
     // No choice to make.
     if (root_moves.size() == 1)
+    {
+        m_result.best_move = root_moves.front();
         return root_moves.front();
+    }
 
     std::sort(root_moves.begin(), root_moves.end(), [&](const Move& a, const Move& b) {
         return move_score(m_board, a) > move_score(m_board, b);
     });
 
-    unsigned n_threads = std::max(1u, std::thread::hardware_concurrency());
-    std::vector<std::thread> workers;
-    workers.reserve(n_threads - 1);
-    for (unsigned t = 1; t < n_threads; ++t) {
-        workers.emplace_back([this, deadline, board_snapshot = BitBoard(m_board)]() mutable {
-            SearchTree worker(board_snapshot, m_tt);
-            worker.run_worker(deadline);
-        });
-    }
-
     std::unique_ptr<Move> best_move;
     int stable_count = 0;
     float prev_score = 0.0f;
@@ -299,26 +706,10 @@ Move SearchTree::search(std::chrono::steady_clock::time_point deadline, PieceCol
 
         while (true)
         {
-            float cur_alpha = alpha;
-            float window_score = -INF;
-            std::unique_ptr<Move> window_best;
-
-            for (const auto& move : root_moves)
-            {
-                if (std::chrono::steady_clock::now() >= deadline) { timed_out = true; break; }
-                m_board.make_move(move);
-                float score = -negamax(-beta, -cur_alpha, depth, true, 1);
-                m_board.unmake_move(move);
-
-                if (score > window_score)
-                {
-                    window_score = score;
-                    window_best  = std::make_unique<Move>(move);
-                }
-                if (score > cur_alpha) cur_alpha = score;
-            }
+            size_t window_idx  = 0;
+            float window_score = search_root(root_moves, alpha, beta, depth, window_idx);
 
-            if (timed_out) break;
+            if (m_aborted) { timed_out = true; break; }
 
             if (window_score <= alpha)
             {
@@ -336,7 +727,7 @@ Move SearchTree::search(std::chrono::steady_clock::time_point deadline, PieceCol
             else
             {
                 // Score is within the window — accept.
-                iteration_best = std::move(window_best);
+                iteration_best = std::make_unique<Move>(root_moves[window_idx]);
                 best_score     = window_score;
                 break;
             }
@@ -347,6 +738,7 @@ Move SearchTree::search(std::chrono::steady_clock::time_point deadline, PieceCol
 
         if (timed_out) break;
 
+        float score_drop = (depth > 1) ? prev_score - best_score : 0.0f;
         prev_score = best_score;
 
         // Track whether the best move changed this iteration.
@@ -354,48 +746,94 @@ Move SearchTree::search(std::chrono::steady_clock::time_point deadline, PieceCol
             bool same = best_move && (*iteration_best == *best_move);
             best_move = std::move(iteration_best);
             stable_count = same ? stable_count + 1 : 0;
+            m_result = { *best_move, best_score, depth };
+        }
+
+        // Multi-PV: the best line drives the time and stopping decisions, the others are only reported.
+        std::vector<SearchResult> lines = { m_result };
+        if (m_limits.multi_pv > 1)
+        {
+            search_other_lines(root_moves, depth, lines);
+
+            // Start the next iteration with the lines in their current order.
+            for (auto it = lines.rbegin(); it != lines.rend(); ++it)
+            {
+                auto pos = std::find(root_moves.begin(), root_moves.end(), it->best_move);
+                std::rotate(root_moves.begin(), pos, pos + 1);
+            }
         }
 
-        if (think_cb && best_move) {
-            int score_cp = static_cast<int>(best_score * 100.0f);
+        if (think_cb) {
             int elapsed_cs = static_cast<int>(
                 std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::steady_clock::now() - search_start).count() / 10);
-            think_cb(depth, score_cp, elapsed_cs, m_nodes, extract_principal_variation(*best_move, depth + 1));
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                int score_cp = static_cast<int>(lines[i].score * 100.0f);
+                think_cb(depth, score_cp, elapsed_cs, m_nodes,
+                         extract_principal_variation(lines[i].best_move, depth + 1), static_cast<uint8_t>(i + 1));
+            }
         }
 
-        // A forced mate was found — no deeper search can improve on this.
-        if (best_score >= 150.0f)
+        // An extra line was cut short: this depth is only partly reported.
+        if (m_aborted)
+            break;
+
+        // A forced mate within the searched depth — no deeper search can find a shorter one.
+        if (best_score >= MATE_THRESHOLD && MATE_SCORE - best_score <= depth)
+            break;
+
+        if (m_stop.load(std::memory_order_relaxed))
             break;
 
-        // Best move has been stable for 3 consecutive depths — confident enough to stop.
-        if (depth >= 4 && stable_count >= 3)
+        // Keep thinking until the opponent moves: limits only apply after a ponder hit.
+        if (pondering() || m_limits.infinite)
+            continue;
+
+        if (m_limits.max_depth && depth >= *m_limits.max_depth)
+            break;
+
+        if (limit_reached())
             break;
 
-        if (std::chrono::steady_clock::now() >= deadline)
+        auto now = std::chrono::steady_clock::now();
+
+        if (m_limits.soft_deadline)
+        {
+            // Spend the allocated time, scaled by how settled the best move is. Stability
+            // means nothing until there is a previous iteration to compare against.
+            // After a ponder hit the budget runs from the hit, not from the start of pondering.
+            auto budget = *m_limits.soft_deadline - m_limits.start;
+            float scale = depth > 1 ? soft_time_scale(stable_count, score_drop) : 1.0f;
+            auto scaled = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                budget * scale * NEW_ITERATION_FRACTION);
+            if (now - m_limits.start >= scaled)
+                break;
+        }
+        else if (!m_limits.max_depth && !m_limits.max_nodes && depth >= 4 && stable_count >= 3)
+        {
+            // No time target: best move has been stable for 3 consecutive depths — confident enough to stop.
             break;
+        }
     }
 
-    for (auto& w : workers)
-        w.join();
+    // Out of time before the first iteration completed.
+    if (!best_move)
+    {
+        m_result.best_move = root_moves.front();
+        return root_moves.front();
+    }
 
     return *best_move;
 }
 
 
-SearchTree::SearchTree(BitBoard& board) :
-    hasher(std::make_unique<ZobristHash>()),
-    m_tt_storage(std::make_unique<std::array<TTEntry, TT_SIZE>>()),
-    m_tt(*m_tt_storage),
-    m_board(board),
-    m_mult(1.0)
-{
-}
-
-SearchTree::SearchTree(BitBoard& board, std::array<TTEntry, TT_SIZE>& shared_tt) :
-    hasher(std::make_unique<ZobristHash>()),
-    m_tt_storage(nullptr),
-    m_tt(shared_tt),
+SearchTree::SearchTree(BitBoard& board, TranspositionTable& tt, const ZobristHash& hasher,
+                       const std::atomic<bool>& stop, const PonderControl& ponder) :
+    hasher(hasher),
+    m_tt(tt),
+    m_stop(stop),
+    m_ponder(ponder),
     m_board(board),
     m_mult(1.0)
 {
@@ -1,55 +1,158 @@
 #pragma once
 
 #include "move.h"
+#include "abdada_table.h"
 #include "bitboards/bitboard.h"
+#include "eval_cache.h"
+#include "heuristic.h"
+#include "position_history.h"
 #include "search_tree_node.h"
+#include "time_manager.h"
+#include "transposition_table.h"
 
 #include "utils/board_strings.h"
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
-#include <thread>
+#include <optional>
+#include <vector>
 
 
-struct TTEntry {
-    enum class Flag : uint8_t { EMPTY, EXACT, LOWER_BOUND, UPPER_BOUND };
-    uint64_t key = 0;
+// Scores are in pawns from the side to move's point of view. A forced mate scores MATE_SCORE
+// less the number of plies to mate (negated when being mated), so shorter mates score higher.
+// Any score beyond MATE_THRESHOLD is a mate.
+inline constexpr float MATE_SCORE = 200.f;
+inline constexpr int MAX_MATE_PLY = 64;
+inline constexpr float MATE_THRESHOLD = MATE_SCORE - MAX_MATE_PLY;
+
+//! Moves to mate for a score in centipawns as passed to ThinkCallback
+/*!
+ * \return positive if the side to move mates, negative if it is mated, nothing for other scores
+ */
+std::optional<int> mate_in_moves(int score_cp);
+
+
+// Outcome of the deepest iteration a search thread completed.
+struct SearchResult {
     Move best_move;
     float score = 0.f;
-    uint8_t depth = 0;
-    Flag flag = Flag::EMPTY;
+    uint8_t depth = 0;  // 0 if no iteration completed
+};
+
+
+// Shared by the threads of a pondering search. While pondering is set, no time limit or stable-move
+// rule ends the search. On a ponder hit the owner writes hit_limits and then clears pondering, and
+// each thread picks up the new limits without losing its iteration state.
+struct PonderControl {
+    std::atomic<bool> pondering = false;
+    SearchLimits hit_limits;
+};
+
+
+// Selective pruning in negamax. Each technique can be switched off or tuned, e.g. to compare
+// settings in self-play. Margins are in centipawns per ply of remaining depth, and each technique
+// only applies within its depth of the leaves.
+struct PruningParams {
+    bool reverse_futility = true;
+    int reverse_futility_margin = 90;
+    int reverse_futility_depth = 6;
+
+    bool futility = true;
+    int futility_margin = 120;
+    int futility_depth = 3;
+
+    bool razoring = true;
+    int razor_margin = 250;
+    int razor_depth = 2;
+
+    // Quiet moves searched before the rest are skipped: late_move_count + depth^2
+    bool late_move_pruning = true;
+    int late_move_count = 3;
+    int late_move_depth = 3;
 };
 
 
-// Called after each completed depth: depth, score in centipawns, elapsed centiseconds, nodes, pv string.
-using ThinkCallback = std::function<void(uint8_t, int, int, uint64_t, const std::string&)>;
+// Called after each completed depth, once per line in Multi-PV mode: depth, score in centipawns,
+// elapsed centiseconds, nodes, pv string, line number (1 for the best line).
+using ThinkCallback = std::function<void(uint8_t, int, int, uint64_t, const std::string&, uint8_t)>;
 
 class SearchTree
 {
 private:
-    static constexpr size_t TT_SIZE = 1 << 20; // ~16 MB
     static constexpr uint8_t MAX_DEPTH = 20;
 
-    std::unique_ptr<ZobristHash> hasher;
-    std::unique_ptr<std::array<TTEntry, TT_SIZE>> m_tt_storage;
-    std::array<TTEntry, TT_SIZE>& m_tt;
+    // Shared between all search threads
+    const ZobristHash& hasher;
+    TranspositionTable& m_tt;
+    const std::atomic<bool>& m_stop;
+    AbdadaTable* m_abdada = nullptr;    // set when running as an ABDADA thread
+    const PonderControl& m_ponder;
 
     BitBoard& m_board;
     float m_mult;
-    uint64_t m_nodes = 0;
+    std::atomic<uint64_t> m_nodes = 0;    // only written by this thread, read by the pool for totals
+
+    EvalTables m_eval_tables;
+    EvalCache m_eval_cache;
+    EvalStats m_eval_stats;
+
+    // Game positions up to the root, then the current search path
+    PositionHistory m_history;
+
+    PruningParams m_pruning;
+
+    SearchLimits m_limits;
+    bool m_pondering = false;
+    bool m_aborted = false;
+    SearchResult m_result;
 
     std::array<std::array<Move, 2>, MAX_DEPTH + 1> m_killers{};
 
-    float quiescence(float alpha, float beta);
+    float evaluate(uint64_t hash, float alpha = -MATE_SCORE, float beta = MATE_SCORE);
+    float quiescence(float alpha, float beta, uint8_t ply);
     float negamax(float alpha, float beta, uint8_t depth_left, bool null_move_ok = true, uint8_t ply = 0);
-    void run_worker(std::chrono::steady_clock::time_point deadline);
+    bool out_of_time();
+    bool limit_reached() const;
+    bool pondering();
+    void start_history();
+    float search_root(const BitBoard::MoveList& root_moves, float alpha, float beta, uint8_t depth, size_t& best_idx);
+    void search_other_lines(BitBoard::MoveList root_moves, uint8_t depth, std::vector<SearchResult>& lines);
     std::string extract_principal_variation(const Move& first_move, int depth) const;
 
-    SearchTree(BitBoard& board, std::array<TTEntry, TT_SIZE>& shared_tt);
-
 public:
-    Move search(std::chrono::steady_clock::time_point deadline, PieceColour ai_colour,
+    //! Iterative deepening search from the root, reporting each completed depth
+    Move search(const SearchLimits& limits, PieceColour ai_colour,
                 ThinkCallback think_cb = nullptr);
 
-    SearchTree(BitBoard& board);
+    //! Helper search: fills the shared TT until stopped or out of time
+    /*!
+     * \param thread_idx index of the helper (from 1), used to diversify a Lazy SMP search
+     */
+    void run_worker(const SearchLimits& limits, unsigned thread_idx);
+
+    const SearchResult& get_result() const { return m_result; }
+    uint64_t get_nodes() const { return m_nodes.load(std::memory_order_relaxed); }
+    const HashStats& get_pawn_hash_stats() const { return m_eval_tables.pawns.stats(); }
+    const HashStats& get_material_hash_stats() const { return m_eval_tables.material.stats(); }
+    const HashStats& get_eval_cache_stats() const { return m_eval_cache.stats(); }
+    const EvalStats& get_eval_stats() const { return m_eval_stats; }
+
+    //! Positions played before the next search, ending with its root
+    /*!
+     * Used to score repetitions of game positions and fifty-move draws. A history that doesn't
+     * end at the root is ignored, leaving only repetitions within the search.
+     */
+    void set_history(const PositionHistory& history) { m_history = history; }
+
+    void set_pruning(const PruningParams& params) { m_pruning = params; }
+
+    //! Forget cached evaluations, e.g. when changing how positions are evaluated
+    void clear_eval_cache() { m_eval_cache.clear(); }
+
+    //! Share work through the given table (ABDADA), or pass nullptr for independent Lazy SMP threads
+    void set_abdada_table(AbdadaTable* table) { m_abdada = table; }
+
+    SearchTree(BitBoard& board, TranspositionTable& tt, const ZobristHash& hasher, const std::atomic<bool>& stop,
+               const PonderControl& ponder);
 };
\ No newline at end of file
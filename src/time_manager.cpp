@@ -0,0 +1,104 @@
+#include "time_manager.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+void TimeManager::set_level(int moves_per_session, int base_ms, int increment_ms)
+{
+    m_moves_per_session = std::max(0, moves_per_session);
+    m_base_ms = std::max(0, base_ms);
+    m_increment_ms = std::max(0, increment_ms);
+    m_fixed_move_ms = std::nullopt;
+
+    // The clock starts at the base time until xboard tells us otherwise.
+    m_time_remaining_ms = m_base_ms;
+}
+
+bool TimeManager::set_level(const std::string& mps, const std::string& base, const std::string& inc)
+{
+    char* end = nullptr;
+
+    long moves = std::strtol(mps.c_str(), &end, 10);
+    if (end == mps.c_str() || *end != '\0')
+        return false;
+
+    // BASE is 'minutes' or 'minutes:seconds'
+    long minutes = std::strtol(base.c_str(), &end, 10);
+    if (end == base.c_str())
+        return false;
+
+    long seconds = 0;
+    if (*end == ':')
+    {
+        const char* sec_str = end + 1;
+        seconds = std::strtol(sec_str, &end, 10);
+        if (end == sec_str)
+            return false;
+    }
+    if (*end != '\0')
+        return false;
+
+    double increment = std::strtod(inc.c_str(), &end);
+    if (end == inc.c_str() || *end != '\0')
+        return false;
+
+    set_level(static_cast<int>(moves),
+              static_cast<int>((minutes * 60 + seconds) * 1000),
+              static_cast<int>(increment * 1000.0));
+    return true;
+}
+
+void TimeManager::set_fixed_move_time(int move_ms)
+{
+    m_fixed_move_ms = std::max(1, move_ms);
+}
+
+void TimeManager::set_time_remaining(int centiseconds)
+{
+    m_time_remaining_ms = std::max(0, centiseconds * 10);
+}
+
+void TimeManager::set_opponent_time(int centiseconds)
+{
+    m_opponent_time_ms = std::max(0, centiseconds * 10);
+}
+
+SearchLimits TimeManager::allocate(int moves_made) const
+{
+    SearchLimits limits;
+
+    if (m_fixed_move_ms)
+    {
+        auto move_time = std::chrono::milliseconds(std::max(1, *m_fixed_move_ms - MOVE_OVERHEAD_MS));
+        limits.soft_deadline = limits.start + move_time;
+        limits.hard_deadline = limits.start + move_time;
+        return limits;
+    }
+
+    double remaining = std::max(0, m_time_remaining_ms - MOVE_OVERHEAD_MS);
+
+    int moves_to_go = m_moves_per_session > 0 ?
+        m_moves_per_session - (moves_made % m_moves_per_session) :
+        DEFAULT_MOVES_TO_GO;
+
+    double soft_ms = remaining / moves_to_go + 0.75 * m_increment_ms;
+
+    // Spend a little more when we are ahead on the clock and a little less when behind.
+    if (m_opponent_time_ms && *m_opponent_time_ms > 0)
+    {
+        double ratio = static_cast<double>(m_time_remaining_ms) / *m_opponent_time_ms;
+        soft_ms *= std::clamp(ratio, 0.75, 1.25);
+    }
+
+    // Never plan to use more than a fraction of the clock on one move, unless it is the last
+    // move before the time control.
+    double max_ms = moves_to_go == 1 ? 0.9 * remaining : 0.5 * remaining;
+
+    soft_ms = std::clamp(soft_ms, 1.0, std::max(1.0, max_ms));
+    double hard_ms = std::clamp(soft_ms * MAX_SOFT_MULTIPLE, soft_ms, std::max(soft_ms, max_ms));
+
+    limits.soft_deadline = limits.start + std::chrono::milliseconds(static_cast<int64_t>(soft_ms));
+    limits.hard_deadline = limits.start + std::chrono::milliseconds(static_cast<int64_t>(hard_ms));
+
+    return limits;
+}
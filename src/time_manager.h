@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Time limits for a single search.
+struct SearchLimits
+{
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point start = clock::now();
+
+    // Optimum time to spend. The search scales this up when the best move is unstable or the
+    // score drops, and down when the best move is stable. If neither this nor max_depth is set,
+    // the search runs until the best move is stable or the hard deadline is reached.
+    std::optional<clock::time_point> soft_deadline;
+
+    // The search is aborted when this is reached, even mid-iteration.
+    clock::time_point hard_deadline = clock::time_point::max();
+
+    // If set, stop after completing this depth.
+    std::optional<uint8_t> max_depth;
+
+    // If set, each thread stops once it has searched this many nodes.
+    std::optional<uint64_t> max_nodes;
+
+    // Search until stopped, ignoring every other limit.
+    bool infinite = false;
+
+    // Number of best root moves to find and report at each depth (Multi-PV).
+    uint8_t multi_pv = 1;
+
+    //! The same limits with the clock restarted at the given time, e.g. on a ponder hit
+    SearchLimits restarted_at(clock::time_point now) const
+    {
+        SearchLimits limits = *this;
+        limits.start = now;
+        if (soft_deadline)
+            limits.soft_deadline = now + (*soft_deadline - start);
+        if (hard_deadline != clock::time_point::max())
+            limits.hard_deadline = now + (hard_deadline - start);
+        return limits;
+    }
+
+    static SearchLimits until(clock::time_point deadline)
+    {
+        SearchLimits limits;
+        limits.hard_deadline = deadline;
+        return limits;
+    }
+};
+
+// Allocates per-move search time from the xboard clock state (level, st, time and otim).
+class TimeManager
+{
+private:
+    int m_moves_per_session = 0;    // 0 = whole game in base time (plus increment)
+    int m_base_ms = 5 * 60 * 1000;
+    int m_increment_ms = 0;
+    std::optional<int> m_fixed_move_ms;
+
+    int m_time_remaining_ms = 5 * 60 * 1000;
+    std::optional<int> m_opponent_time_ms;
+
+public:
+    // Moves-to-go estimate used when the time control has no session length.
+    static constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+    // Kept in reserve to cover GUI and process latency.
+    static constexpr int MOVE_OVERHEAD_MS = 30;
+
+    // The hard limit is at most this multiple of the soft limit.
+    static constexpr int MAX_SOFT_MULTIPLE = 5;
+
+    //! Set a conventional or incremental time control
+    /*!
+     * \param moves_per_session moves to make in each session, 0 for sudden death/increment
+     * \param base_ms time for the session
+     * \param increment_ms time added after each move
+     */
+    void set_level(int moves_per_session, int base_ms, int increment_ms);
+
+    //! Parse the parameters of an xboard 'level MPS BASE INC' command
+    /*!
+     * BASE is either minutes or 'minutes:seconds', INC is in (possibly fractional) seconds.
+     * \return false if the parameters could not be parsed
+     */
+    bool set_level(const std::string& mps, const std::string& base, const std::string& inc);
+
+    //! Use a fixed time per move, as set by the xboard 'st' command
+    void set_fixed_move_time(int move_ms);
+
+    void set_time_remaining(int centiseconds);
+    void set_opponent_time(int centiseconds);
+
+    //! Compute limits for the next move
+    /*!
+     * \param moves_made number of moves the engine has already made in this game
+     */
+    SearchLimits allocate(int moves_made) const;
+
+    int get_time_remaining_ms() const { return m_time_remaining_ms; }
+};
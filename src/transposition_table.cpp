@@ -0,0 +1,36 @@
+#include "transposition_table.h"
+
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t size_mb)
+{
+    resize(size_mb);
+}
+
+void TranspositionTable::resize(size_t size_mb)
+{
+    size_mb = std::clamp<size_t>(size_mb, 1, MAX_SIZE_MB);
+
+    size_t max_entries = size_mb * 1024 * 1024 / sizeof(TTEntry);
+    size_t entries = 1;
+    while (entries * 2 <= max_entries)
+        entries *= 2;
+
+    // Release the old table first so peak memory stays near the requested size.
+    m_entries = std::vector<TTEntry>();
+    m_entries.resize(entries);
+    m_mask = entries - 1;
+}
+
+void TranspositionTable::clear()
+{
+    std::fill(m_entries.begin(), m_entries.end(), TTEntry{});
+}
+
+int TranspositionTable::hashfull() const
+{
+    size_t sample = std::min<size_t>(1000, m_entries.size());
+    size_t used = std::count_if(m_entries.begin(), m_entries.begin() + sample,
+                                [](const TTEntry& e) { return e.flag != TTEntry::Flag::EMPTY; });
+    return static_cast<int>(used * 1000 / sample);
+}
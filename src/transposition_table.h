@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "move.h"
+
+struct TTEntry {
+    enum class Flag : uint8_t { EMPTY, EXACT, LOWER_BOUND, UPPER_BOUND };
+    uint64_t key = 0;
+    Move best_move;
+    float score = 0.f;
+    uint8_t depth = 0;
+    Flag flag = Flag::EMPTY;
+};
+
+// Always-replace hash table shared by all search threads. The number of entries is rounded
+// down to a power of two so an entry is found by masking the hash.
+class TranspositionTable
+{
+private:
+    std::vector<TTEntry> m_entries;
+    uint64_t m_mask = 0;
+
+public:
+    static constexpr size_t DEFAULT_SIZE_MB = 32;
+    static constexpr size_t MAX_SIZE_MB = 4096;
+
+    explicit TranspositionTable(size_t size_mb = DEFAULT_SIZE_MB);
+
+    //! Resize the table to at most size_mb megabytes, discarding its contents
+    void resize(size_t size_mb);
+
+    void clear();
+
+    TTEntry& entry(uint64_t hash) { return m_entries[hash & m_mask]; }
+    const TTEntry& entry(uint64_t hash) const { return m_entries[hash & m_mask]; }
+
+    //! Permille of entries in use, estimated from the start of the table (UCI 'hashfull')
+    int hashfull() const;
+
+    size_t size() const { return m_entries.size(); }
+};
@@ -0,0 +1,184 @@
+#include "uci_interface.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+UciInterface::CommandReceived::CommandReceived(const std::string& rcvd) :
+    m_raw(rcvd)
+{
+    std::istringstream iss(rcvd);
+    std::string token;
+    while (iss >> token)
+        m_params.push_back(token);
+
+    if (m_params.empty())
+        return;
+
+    std::string command = m_params.front();
+    m_params.pop_front();
+
+    if (command == "uci")               m_type = UCI;
+    else if (command == "debug")        m_type = DEBUG;
+    else if (command == "isready")      m_type = ISREADY;
+    else if (command == "setoption")    m_type = SETOPTION;
+    else if (command == "ucinewgame")   m_type = UCINEWGAME;
+    else if (command == "position")     m_type = POSITION;
+    else if (command == "go")           m_type = GO;
+    else if (command == "stop")         m_type = STOP;
+    else if (command == "ponderhit")    m_type = PONDERHIT;
+    else if (command == "quit")         m_type = QUIT;
+    else                                m_invalid = true;
+
+    if (m_type == POSITION && (m_params.empty() || (m_params.front() != "startpos" && m_params.front() != "fen")))
+        m_invalid = true;
+}
+
+std::string UciInterface::CommandReceived::join_params(size_t from, size_t to) const
+{
+    std::string ret;
+    for (size_t i = from; i < to && i < m_params.size(); ++i)
+    {
+        if (!ret.empty()) ret += ' ';
+        ret += m_params[i];
+    }
+    return ret;
+}
+
+std::optional<int64_t> UciInterface::CommandReceived::get_go_param(const std::string& name) const
+{
+    auto it = std::find(m_params.begin(), m_params.end(), name);
+    if (it == m_params.end() || it + 1 == m_params.end())
+        return std::nullopt;
+
+    char* end = nullptr;
+    long long value = std::strtoll((it + 1)->c_str(), &end, 10);
+    if (end == (it + 1)->c_str() || *end != '\0')
+        return std::nullopt;
+
+    return value;
+}
+
+bool UciInterface::CommandReceived::has_go_flag(const std::string& name) const
+{
+    return std::find(m_params.begin(), m_params.end(), name) != m_params.end();
+}
+
+std::string UciInterface::CommandReceived::get_option_name() const
+{
+    auto name = std::find(m_params.begin(), m_params.end(), "name");
+    auto value = std::find(m_params.begin(), m_params.end(), "value");
+    if (name == m_params.end())
+        return "";
+
+    return join_params(name - m_params.begin() + 1, value - m_params.begin());
+}
+
+std::string UciInterface::CommandReceived::get_option_value() const
+{
+    auto value = std::find(m_params.begin(), m_params.end(), "value");
+    if (value == m_params.end())
+        return "";
+
+    return join_params(value - m_params.begin() + 1, m_params.size());
+}
+
+std::string UciInterface::CommandReceived::get_position_fen() const
+{
+    if (m_params.empty() || m_params.front() == "startpos")
+        return "startpos";
+
+    auto moves = std::find(m_params.begin(), m_params.end(), "moves");
+    return join_params(1, moves - m_params.begin());
+}
+
+std::vector<std::string> UciInterface::CommandReceived::get_position_moves() const
+{
+    auto moves = std::find(m_params.begin(), m_params.end(), "moves");
+    if (moves == m_params.end())
+        return {};
+
+    return std::vector<std::string>(moves + 1, m_params.end());
+}
+
+UciInterface::UciInterface(std::shared_ptr<InputReader> input, std::ostream& outstr,
+                           const std::string& app_name, const std::string& author) :
+    m_input(std::move(input)),
+    m_outstr(outstr),
+    m_app_name(app_name),
+    m_author(author)
+{
+    outstr.setf(std::ios::unitbuf);
+}
+
+UciInterface::CommandReceived UciInterface::wait_for_command()
+{
+    return CommandReceived(m_input->read_line());
+}
+
+std::optional<UciInterface::CommandReceived> UciInterface::poll_command(std::chrono::milliseconds timeout)
+{
+    auto rcvd = m_input->poll_line(timeout);
+    if (!rcvd)
+        return std::nullopt;
+    return CommandReceived(*rcvd);
+}
+
+void UciInterface::add_option(const std::string& option_str)
+{
+    m_options.push_back(option_str);
+}
+
+void UciInterface::reply_uci()
+{
+    std::lock_guard lock(m_out_mutex);
+
+    m_outstr << "id name " << m_app_name << std::endl;
+    m_outstr << "id author " << m_author << std::endl;
+
+    for (const auto& option : m_options)
+        m_outstr << "option name " << option << std::endl;
+
+    m_outstr << "uciok" << std::endl;
+}
+
+void UciInterface::reply_readyok()
+{
+    std::lock_guard lock(m_out_mutex);
+    m_outstr << "readyok" << std::endl;
+}
+
+void UciInterface::send_info(uint8_t depth, int score_cp, int elapsed_ms, uint64_t nodes, int hashfull,
+                             const std::string& pv, std::optional<int> multipv, std::optional<int> mate_moves)
+{
+    uint64_t nps = nodes * 1000 / std::max(elapsed_ms, 1);
+
+    std::lock_guard lock(m_out_mutex);
+    m_outstr << "info depth " << static_cast<int>(depth);
+    if (multipv)
+        m_outstr << " multipv " << *multipv;
+    if (mate_moves)
+        m_outstr << " score mate " << *mate_moves;
+    else
+        m_outstr << " score cp " << score_cp;
+    m_outstr << " time " << elapsed_ms
+             << " nodes " << nodes
+             << " nps " << nps
+             << " hashfull " << hashfull
+             << " pv " << pv << std::endl;
+}
+
+void UciInterface::send_info_string(const std::string& info)
+{
+    std::lock_guard lock(m_out_mutex);
+    m_outstr << "info string " << info << std::endl;
+}
+
+void UciInterface::send_bestmove(const std::string& move, const std::optional<std::string>& ponder_move)
+{
+    std::lock_guard lock(m_out_mutex);
+    m_outstr << "bestmove " << move;
+    if (ponder_move)
+        m_outstr << " ponder " << *ponder_move;
+    m_outstr << std::endl;
+}
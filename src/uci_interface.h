@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "input_reader.h"
+
+class UciInterface
+{
+public:
+    class CommandReceived
+    {
+    public:
+        typedef enum {
+            UCI,
+            DEBUG,
+            ISREADY,
+            SETOPTION,
+            UCINEWGAME,
+            POSITION,
+            GO,
+            STOP,
+            PONDERHIT,
+            QUIT,
+            NONE
+        } type_t;
+
+    public:
+        CommandReceived(const std::string& rcvd);
+
+        std::string raw_str() const { return m_raw; }
+        bool is_invalid() const { return m_invalid; }
+        type_t get_type() const { return m_type; }
+
+        //! Tokens following the command word
+        const std::deque<std::string>& get_params() const { return m_params; }
+
+        //! Value following a 'go' keyword such as wtime or depth, if present and numeric
+        std::optional<int64_t> get_go_param(const std::string& name) const;
+
+        //! Whether a bare 'go' keyword such as infinite or ponder is present
+        bool has_go_flag(const std::string& name) const;
+
+        //! For 'setoption name NAME value VALUE', the option name and value (which may contain spaces)
+        std::string get_option_name() const;
+        std::string get_option_value() const;
+
+        //! For 'position', the FEN (or 'startpos') and the moves that follow it
+        std::string get_position_fen() const;
+        std::vector<std::string> get_position_moves() const;
+
+    private:
+        std::string m_raw;
+        bool m_invalid = false;
+        type_t m_type = NONE;
+        std::deque<std::string> m_params;
+
+        std::string join_params(size_t from, size_t to) const;
+    };
+
+public:
+    UciInterface(std::shared_ptr<InputReader> input, std::ostream& outstr,
+                 const std::string& app_name, const std::string& author);
+
+    CommandReceived wait_for_command();
+
+    //! Wait up to timeout for a command, returning nothing if none arrived
+    std::optional<CommandReceived> poll_command(std::chrono::milliseconds timeout);
+
+    //! Add an option to announce in reply to 'uci', e.g. "Hash type spin default 32 min 1 max 4096"
+    void add_option(const std::string& option_str);
+
+    //! Reply to 'uci' with id, options and uciok
+    void reply_uci();
+    void reply_readyok();
+
+    //! Report a completed depth
+    /*!
+     * \param multipv line number, only given when more than one line is being searched
+     * \param mate_moves if set, report a mate in this many moves (negative if being mated) instead of score_cp
+     */
+    void send_info(uint8_t depth, int score_cp, int elapsed_ms, uint64_t nodes, int hashfull,
+                   const std::string& pv, std::optional<int> multipv = std::nullopt,
+                   std::optional<int> mate_moves = std::nullopt);
+    void send_info_string(const std::string& info);
+    void send_bestmove(const std::string& move, const std::optional<std::string>& ponder_move = std::nullopt);
+
+private:
+    std::shared_ptr<InputReader> m_input;
+    std::ostream& m_outstr;
+
+    // Info lines come from the search thread, so all writes are serialised.
+    std::mutex m_out_mutex;
+
+    std::string m_app_name;
+    std::string m_author;
+    std::vector<std::string> m_options;
+};
@@ -3,7 +3,9 @@
 #include <string>
 #include <sstream>
 #include <cassert>
+#include <cctype>
 #include <iostream>
+#include <stdexcept>
 
 #include "../bitboards/bitboard.h"
 
@@ -59,7 +61,7 @@ namespace utils
         // fullmove clock and halfmove clock are tokens[3] and tokens[4] respectively
     }
 
-    static std::string write_fen_props_line(const BitBoard& board)
+    inline std::string write_fen_props_line(const BitBoard& board)
     {
         std::ostringstream oss;
 
@@ -199,11 +201,118 @@ namespace utils
                 ++col_idx;
             }
         }
-        std::cout << s << std::endl;
+        return ret;
+    }
+
+    //! Standard FEN of the starting position
+    static const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    //! Parse a position in Forsyth-Edwards Notation
+    /*!
+     * The halfmove and fullmove counters are optional and ignored here, see fen_halfmove_clock().
+     * \throw std::runtime_error if the placement, side to move, castling or en passant field is malformed
+     */
+    template<IsBoard T>
+    static T board_from_fen(const std::string& fen)
+    {
+        std::istringstream iss(fen);
+        std::string placement, side, castling = "-", ep = "-";
+        iss >> placement >> side >> castling >> ep;
+
+        if (placement.empty() || (side != "w" && side != "b"))
+            throw std::runtime_error("Invalid FEN: " + fen);
+
+        T ret;
+
+        int row_idx = 7, col_idx = 0;
+        for (char chr : placement)
+        {
+            if (chr == '/')
+            {
+                if (col_idx != 8 || --row_idx < 0)
+                    throw std::runtime_error("Invalid FEN: " + fen);
+                col_idx = 0;
+            }
+            else if (chr >= '1' && chr <= '8')
+            {
+                col_idx += chr - '0';
+            }
+            else
+            {
+                PieceType type;
+                switch (std::tolower(chr))
+                {
+                case 'p': type = PieceType::PAWN;   break;
+                case 'n': type = PieceType::KNIGHT; break;
+                case 'b': type = PieceType::BISHOP; break;
+                case 'r': type = PieceType::ROOK;   break;
+                case 'q': type = PieceType::QUEEN;  break;
+                case 'k': type = PieceType::KING;   break;
+                default:
+                    throw std::runtime_error("Invalid FEN: " + fen);
+                }
+
+                if (col_idx > 7)
+                    throw std::runtime_error("Invalid FEN: " + fen);
+
+                PieceColour colour = std::isupper(chr) ? PieceColour::WHITE : PieceColour::BLACK;
+                ret.add_piece(type, colour, BoardLocation(col_idx, row_idx));
+                ++col_idx;
+            }
+
+            if (col_idx > 8)
+                throw std::runtime_error("Invalid FEN: " + fen);
+        }
+        if (row_idx != 0 || col_idx != 8)
+            throw std::runtime_error("Invalid FEN: " + fen);
+
+        ret.set_colour_to_move(side == "w" ? PieceColour::WHITE : PieceColour::BLACK);
+
+        std::vector<BitBoard::CastlingRights> castling_rights;
+        for (char chr : castling)
+        {
+            switch (chr)
+            {
+            case 'K': castling_rights.push_back(BitBoard::CastlingRights::WHITE_KINGSIDE);  break;
+            case 'Q': castling_rights.push_back(BitBoard::CastlingRights::WHITE_QUEENSIDE); break;
+            case 'k': castling_rights.push_back(BitBoard::CastlingRights::BLACK_KINGSIDE);  break;
+            case 'q': castling_rights.push_back(BitBoard::CastlingRights::BLACK_QUEENSIDE); break;
+            case '-': break;
+            default:
+                throw std::runtime_error("Invalid FEN: " + fen);
+            }
+        }
+        ret.set_castling_rights(castling_rights);
+
+        if (ep != "-")
+        {
+            if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h')
+                throw std::runtime_error("Invalid FEN: " + fen);
+            ret.set_enpassant_column(static_cast<uint8_t>(ep[0] - 'a'));
+        }
 
         return ret;
     }
 
+    //! Halfmove clock (plies since the last capture or pawn move) of a FEN, 0 if it is absent
+    /*!
+     * \throw std::runtime_error if the field is present but not a non-negative number
+     */
+    inline int fen_halfmove_clock(const std::string& fen)
+    {
+        std::istringstream iss(fen);
+        std::string field;
+        for (int i = 0; i < 5; ++i)
+        {
+            if (!(iss >> field))
+                return 0;
+        }
+
+        if (field.empty() || field.size() > 6 || field.find_first_not_of("0123456789") != std::string::npos)
+            throw std::runtime_error("Invalid FEN: " + fen);
+        return std::stoi(field);
+    }
+
     template<IsBoard T>
     static std::string board_to_string_repr(const T& board)
     {
@@ -2,16 +2,22 @@
 #include <csignal>
 
 XBoardInterface::XBoardInterface(std::istream& instr, std::ostream& outstr, const std::string& app_name) :
-    m_instr(instr),
+    XBoardInterface(std::make_shared<InputReader>(instr), outstr, app_name)
+{
+    instr.setf(std::ios::unitbuf);
+}
+
+XBoardInterface::XBoardInterface(std::shared_ptr<InputReader> input, std::ostream& outstr, const std::string& app_name) :
+    m_input(std::move(input)),
     m_outstr(outstr),
     m_app_name(app_name)
 {
-    instr.setf(std::ios::unitbuf);
     outstr.setf(std::ios::unitbuf);
     signal(SIGINT, SIG_IGN);
 }
 
 void XBoardInterface::reply_result(Result result){
+    std::lock_guard lock(m_out_mutex);
 
     switch(result)
     {
@@ -35,13 +41,27 @@ void XBoardInterface::tell_info(const std::string& infostring)
     write_command("tellics say", infostring);
 }
 
-void XBoardInterface::send_thinking(uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& move)
+void XBoardInterface::send_thinking(uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& move,
+                                    std::optional<int> mate_moves)
 {
+    // xboard's convention for mate scores: 100000 + N for mate in N, -100000 - N for mated in N.
+    if (mate_moves)
+        score_cp = *mate_moves > 0 ? 100000 + *mate_moves : -100000 + *mate_moves;
+
+    std::lock_guard lock(m_out_mutex);
     m_outstr << static_cast<int>(depth) << " " << score_cp << " " << elapsed_cs << " " << nodes << " " << move << "\n";
 }
 
+void XBoardInterface::send_analysis_status(int elapsed_cs, uint64_t nodes, uint8_t depth, int moves_left, int total_moves)
+{
+    std::lock_guard lock(m_out_mutex);
+    m_outstr << "stat01: " << elapsed_cs << " " << nodes << " " << static_cast<int>(depth) << " "
+             << moves_left << " " << total_moves << std::endl;
+}
+
 void XBoardInterface::write_command(const std::string& command, const std::string& content)
 {
+    std::lock_guard lock(m_out_mutex);
     m_outstr << command << " " << content << std::endl;
 }
 
@@ -57,6 +77,7 @@ void XBoardInterface::reply_illegal_move(CommandReceived rcvd)
 
 void XBoardInterface::reply_newline()
 {
+    std::lock_guard lock(m_out_mutex);
     m_outstr << std::endl;
 }
 
@@ -87,6 +108,8 @@ void XBoardInterface::send_move(const std::string& move)
 
 void XBoardInterface::reply_features()
 {
+    std::lock_guard lock(m_out_mutex);
+
     //send name
     m_outstr << "feature myname=\"" << m_app_name << "\"" << std::endl;
 
@@ -123,7 +146,7 @@ std::vector<std::string> XBoardInterface::read_edit_mode()
     std::string rcvd;
 
     do{
-        std::getline(m_instr, rcvd);
+        rcvd = m_input->read_line();
         out.push_back(rcvd);
     }while(rcvd.compare("."));
 
@@ -221,6 +244,44 @@ void XBoardInterface::CommandReceived::parse(const std::string& rcvd)
             m_params = params;
             break;
         }
+        else if(!command.compare("st"))
+        {
+            m_type = ST;
+            m_params = params;
+            break;
+        }
+        else if(!command.compare("cores"))
+        {
+            m_type = CORES;
+            m_params = params;
+            break;
+        }
+        else if(!command.compare("option"))
+        {
+            m_type = OPTION;
+            m_params = params;
+            break;
+        }
+        else if(!command.compare("analyze"))
+        {
+            m_type = ANALYZE;
+            break;
+        }
+        else if(!command.compare("exit"))
+        {
+            m_type = EXIT;
+            break;
+        }
+        else if(!command.compare("."))
+        {
+            m_type = STATUS;
+            break;
+        }
+        else if(!command.compare("?"))
+        {
+            m_type = MOVE_NOW;
+            break;
+        }
         else if(!command.compare("random"))
         {
             m_type = RANDOM;
@@ -246,6 +307,11 @@ void XBoardInterface::CommandReceived::parse(const std::string& rcvd)
             m_type = HARD;
             break;
         }
+        else if(!command.compare("easy"))
+        {
+            m_type = EASY;
+            break;
+        }
         else if(!command.compare("force"))
         {
             m_type = FORCE;
@@ -299,8 +365,13 @@ void XBoardInterface::CommandReceived::parse(const std::string& rcvd)
 
 XBoardInterface::CommandReceived XBoardInterface::wait_for_command()
 {
-    std::string rcvd;
-    std::getline(m_instr, rcvd);
-    return XBoardInterface::CommandReceived(rcvd);
+    return XBoardInterface::CommandReceived(m_input->read_line());
+}
 
+std::optional<XBoardInterface::CommandReceived> XBoardInterface::poll_command(std::chrono::milliseconds timeout)
+{
+    auto rcvd = m_input->poll_line(timeout);
+    if (!rcvd)
+        return std::nullopt;
+    return XBoardInterface::CommandReceived(*rcvd);
 }
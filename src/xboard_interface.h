@@ -7,6 +7,12 @@
 #include <cstdlib>
 #include <cstdint>
 #include <deque>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "input_reader.h"
 
 class XBoardInterface
 {
@@ -25,9 +31,17 @@ public:
             NEW,
             POST,
             HARD,
+            EASY,
+            MOVE_NOW,
+            ANALYZE,
+            EXIT,
+            STATUS,
             QUIT,
             TIME,
             OTIM,
+            ST,
+            CORES,
+            OPTION,
             EDIT,
             FORCE,
             GO,
@@ -92,6 +106,7 @@ public:
 
 public:
     XBoardInterface(std::istream& instr, std::ostream& outstr, const std::string& app_name);
+    XBoardInterface(std::shared_ptr<InputReader> input, std::ostream& outstr, const std::string& app_name);
 
     enum class Result {
         WHITE_WIN,
@@ -101,8 +116,32 @@ public:
 
 public:
     void tell_info(const std::string& infostring);
-    void send_thinking(uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& move);
+    //! Send a line of thinking output
+    /*!
+     * \param mate_moves if set, report a mate in this many moves (negative if being mated) instead of score_cp
+     */
+    void send_thinking(uint8_t depth, int score_cp, int elapsed_cs, uint64_t nodes, const std::string& move,
+                       std::optional<int> mate_moves = std::nullopt);
+
+    //! Reply to '.' in analyze mode
+    /*!
+     * \param moves_left number of root moves still to search in the current iteration
+     * \param total_moves number of legal root moves
+     */
+    void send_analysis_status(int elapsed_cs, uint64_t nodes, uint8_t depth, int moves_left, int total_moves);
     CommandReceived wait_for_command();
+
+    //! Wait up to timeout for a command, returning nothing if none arrived
+    /*!
+     * Only available once start_reader() has been called.
+     */
+    std::optional<CommandReceived> poll_command(std::chrono::milliseconds timeout);
+
+    //! Read input on a background thread from now on, so commands can be polled during a search
+    /*!
+     * End of input is reported as a 'quit' command.
+     */
+    void start_reader() { m_input->start(); }
     void reply_invalid(CommandReceived rcvd);
     void reply_illegal_move(CommandReceived rcvd);
     void reply_ping(CommandReceived rcvd);
@@ -120,9 +159,12 @@ private:
     void write_command(const std::string& command, const std::string& content);
 
 private:
-    std::istream& m_instr;
+    std::shared_ptr<InputReader> m_input;
     std::ostream& m_outstr;
 
+    // Thinking output comes from the search thread, so all writes are serialised.
+    std::mutex m_out_mutex;
+
     std::string m_app_name;
     std::vector<std::string> m_variants;
     std::vector<std::string> m_features;
@@ -18,9 +18,9 @@ size_t ZobristHash::piece_to_index(PieceType type, PieceColour colour) const
 
 ZobristHash::ZobristHash()
 {
-    // Initialise the table with random bitstrings
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
+    // Initialise the table with random bitstrings. The seed is fixed so that every hasher
+    // produces the same keys, e.g. for a game history hashed outside the search.
+    std::mt19937_64 gen(0x4A6F686E63686573ULL);
     std::uniform_int_distribution<uint64_t> dis;
 
     for(int i = 0; i < 64; ++i)
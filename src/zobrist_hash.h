@@ -1,3 +1,5 @@
+#pragma once
+
 #include "bitboards/bitboard.h"
 //#include "pieces.h"
 
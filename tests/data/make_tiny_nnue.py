@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+"""Write tiny.nnue, the test network used by test_nnue.cpp.
+
+Hidden units 0 and 1 count the material of each side, so the network prefers being a piece up;
+the other units have small random weights so every lane of the kernels is exercised.
+"""
+import random
+import struct
+import sys
+
+HIDDEN = 32
+INPUTS = 768
+# King, queen, rook, bishop, knight, pawn: in units of a third of a pawn
+VALUES = [0, 27, 15, 9, 9, 3]
+
+rng = random.Random(1)
+
+input_weights = []
+for feature in range(INPUTS):
+    relative_colour, piece = divmod(feature // 64, 6)
+    row = [VALUES[piece] if relative_colour == 0 else 0,
+           VALUES[piece] if relative_colour == 1 else 0]
+    row += [rng.randint(-4, 4) for _ in range(HIDDEN - 2)]
+    input_weights += row
+
+input_biases = [0, 0] + [rng.randint(20, 60) for _ in range(HIDDEN - 2)]
+us = [127, -127] + [rng.randint(-2, 2) for _ in range(HIDDEN - 2)]
+them = [-127, 127] + [rng.randint(-2, 2) for _ in range(HIDDEN - 2)]
+
+with open(sys.argv[1] if len(sys.argv) > 1 else "tiny.nnue", "wb") as f:
+    f.write(b"JCNN" + struct.pack("<II", 1, HIDDEN))
+    f.write(struct.pack("<%dh" % len(input_weights), *input_weights))
+    f.write(struct.pack("<%dh" % HIDDEN, *input_biases))
+    f.write(struct.pack("<%db" % (2 * HIDDEN), *(us + them)))
+    f.write(struct.pack("<i", 0))
@@ -143,4 +143,23 @@ TEST_F(PerftTests, CheckPosition5)
     EXPECT_EQ(perft(board, 3), 62379);
     EXPECT_EQ(perft(board, 4), 2103487);
     EXPECT_EQ(perft(board, 5), 89941194);
-}
\ No newline at end of file
+}
+
+TEST_F(PerftTests, CheckKiwiPeteFromFen)
+{
+    auto board = board_from_fen<BitBoard>("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    EXPECT_EQ(perft(board, 1), 48);
+    EXPECT_EQ(perft(board, 2), 2039);
+    EXPECT_EQ(perft(board, 3), 97862);
+}
+
+TEST_F(PerftTests, CheckPosition3FromFen)
+{
+    auto board = board_from_fen<BitBoard>("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+
+    EXPECT_EQ(perft(board, 1), 14);
+    EXPECT_EQ(perft(board, 2), 191);
+    EXPECT_EQ(perft(board, 3), 2812);
+    EXPECT_EQ(perft(board, 4), 43238);
+}
@@ -162,7 +162,7 @@ TEST_F(AiTests, ThinkCallbackIncludesPrincipalVariation)
     BasicAI ai(PieceColour::WHITE);
 
     std::string final_variation;
-    ThinkCallback cb = [&](uint8_t, int, int, uint64_t, const std::string& principal_variation) {
+    ThinkCallback cb = [&](uint8_t, int, int, uint64_t, const std::string& principal_variation, uint8_t) {
         final_variation = principal_variation;
     };
 
@@ -221,3 +221,30 @@ TEST_F(AiTests, SingleLegalMoveIsReturnedImmediately)
 
     EXPECT_EQ(move.to_string(), "h1h2");
 }
+
+TEST_F(AiTests, MateScoresCountMovesToMate)
+{
+    EXPECT_EQ(mate_in_moves(static_cast<int>((MATE_SCORE - 1) * 100)), 1);
+    EXPECT_EQ(mate_in_moves(static_cast<int>((MATE_SCORE - 3) * 100)), 2);
+    EXPECT_EQ(mate_in_moves(static_cast<int>((-MATE_SCORE + 2) * 100)), -1);
+    EXPECT_EQ(mate_in_moves(350), std::nullopt);
+    EXPECT_EQ(mate_in_moves(-350), std::nullopt);
+}
+
+TEST_F(AiTests, ReportsShortestMate)
+{
+    // Rook ladder: Rb7 then Ra8 mates, there is no mate in one.
+    auto board = board_from_fen<BitBoard>("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+
+    BasicAI ai(PieceColour::WHITE);
+
+    std::optional<int> mate;
+    ThinkCallback cb = [&](uint8_t, int score_cp, int, uint64_t, const std::string&, uint8_t) {
+        mate = mate_in_moves(score_cp);
+    };
+
+    auto move = ai.make_move(board, deadline(), cb);
+
+    EXPECT_EQ(mate, 2);
+    EXPECT_TRUE(move.to_string() == "a2a7" || move.to_string() == "b1b7");
+}
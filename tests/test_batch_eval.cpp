@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include <batch_eval.h>
+#include <heuristic.h>
+#include <bitboards/bitboard.h>
+#include <utils/board_strings.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace utils;
+
+// Positions from random games. Unless generate_moves is set they are taken before any moves are
+// generated in them, so ShannonHeuristic works out their attack maps from scratch.
+static std::vector<BitBoard> random_positions(unsigned seed, int games, bool generate_moves = false)
+{
+    std::vector<BitBoard> positions;
+    std::mt19937 rng(seed);
+    for (int game = 0; game < games; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+        for (int ply = 0; ply < 250; ++ply)
+        {
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+            board.make_move(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)]);
+            positions.push_back(board);
+            if (generate_moves)
+                positions.back().get_all_legal_moves(board.get_colour_to_move());
+        }
+    }
+    return positions;
+}
+
+static void expect_matches_shannon_heuristic(const std::vector<BitBoard>& positions)
+{
+    PositionBatch batch;
+    for (const auto& board : positions)
+        batch.add(board);
+    ASSERT_EQ(batch.size(), positions.size());
+
+    std::vector<float> scores(batch.size());
+    batch_eval::evaluate(batch, scores);
+
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const BitBoard& board = positions[i];
+        EXPECT_EQ(scores[i], ShannonHeuristic(board, board.get_colour_to_move()).get()) << i;
+    }
+}
+
+TEST(BatchEvalTests, MatchesShannonHeuristic)
+{
+    expect_matches_shannon_heuristic(random_positions(99, 40));
+}
+
+TEST(BatchEvalTests, MatchesShannonHeuristicAfterMoveGeneration)
+{
+    // As in search, where move generation has left its attack maps behind
+    auto positions = random_positions(123, 40, true);
+    for (const char* fen : { "r3k2r/ppp2ppp/2n5/1B1pp3/1b1PP3/2N5/PPP2PPP/R3K2R w KQkq - 0 1",
+                             "r3k2r/ppp2ppp/2n5/1B1pp3/1b1PP3/2N5/PPP2PPP/R3K2R b KQkq - 0 1",
+                             "4k3/4r3/8/8/8/8/4R3/4K3 w - - 0 1" })
+    {
+        positions.push_back(board_from_fen<BitBoard>(fen));
+        positions.back().get_all_legal_moves(positions.back().get_colour_to_move());
+    }
+
+    expect_matches_shannon_heuristic(positions);
+}
+
+TEST(BatchEvalTests, ThreadsGiveSameScores)
+{
+    auto positions = random_positions(7, 10);
+
+    PositionBatch batch;
+    while (batch.size() < 20000)
+    {
+        for (const auto& board : positions)
+            batch.add(board);
+    }
+
+    std::vector<float> one(batch.size()), four(batch.size());
+    batch_eval::evaluate(batch, one, 1);
+    batch_eval::evaluate(batch, four, 4);
+    EXPECT_EQ(one, four);
+
+    std::vector<float> too_few(batch.size() - 1);
+    EXPECT_THROW(batch_eval::evaluate(batch, too_few), std::invalid_argument);
+}
+
+TEST(BatchEvalTests, WritesEpdWithEvaluation)
+{
+    std::istringstream in(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+        "\n"
+        "4k3/8/8/8/8/8/8/4K3 b - - ce 500; id \"a;b\";\n"
+        "4k3/8/8/8/8/8/8/3QK3 b - -\n");
+    std::ostringstream out;
+    batch_eval::evaluate_epd(in, out);
+
+    const float start = ShannonHeuristic(board_from_fen<BitBoard>(START_FEN), PieceColour::WHITE).get();
+    const float queen_down = ShannonHeuristic(board_from_fen<BitBoard>("4k3/8/8/8/8/8/8/3QK3 b - -"),
+                                              PieceColour::BLACK).get();
+    EXPECT_EQ(out.str(),
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - ce " + std::to_string(std::lround(start * 100)) + ";\n"
+        "4k3/8/8/8/8/8/8/4K3 b - - id \"a;b\"; ce 0;\n"
+        "4k3/8/8/8/8/8/8/3QK3 b - - ce " + std::to_string(std::lround(queen_down * 100)) + ";\n");
+    EXPECT_LT(queen_down, -5.f);
+}
+
+TEST(BatchEvalTests, ReportsLineOfMalformedPosition)
+{
+    std::istringstream in(START_FEN + "\nnot a position\n");
+    std::ostringstream out;
+    try
+    {
+        batch_eval::evaluate_epd(in, out);
+        FAIL() << "expected std::runtime_error";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_EQ(std::string(e.what()).rfind("Line 2: ", 0), 0u) << e.what();
+    }
+}
+
+TEST(BatchEvalTests, SkipsMalformedPositionsWhenAskedTo)
+{
+    std::istringstream in(START_FEN + "\nnot a position\n4k3/8/8/8/8/8/8/4K3 b - -\n");
+    std::ostringstream out;
+    std::ostringstream errors;
+    batch_eval::evaluate_epd(in, out, 1, &errors);
+
+    const std::string reported = errors.str();
+    EXPECT_EQ(reported.rfind("Line 2: ", 0), 0u) << reported;
+    EXPECT_EQ(std::count(reported.begin(), reported.end(), '\n'), 1);
+
+    const std::string scored = out.str();
+    EXPECT_EQ(std::count(scored.begin(), scored.end(), '\n'), 2);
+    EXPECT_NE(scored.find("4k3/8/8/8/8/8/8/4K3 b - - ce 0;\n"), std::string::npos) << scored;
+}
@@ -4,6 +4,7 @@
 #include <bitboards/bitboard.h>
 #include <utils/board_strings.h>
 
+#include <random>
 #include <ranges>
 
 using namespace utils;
@@ -1143,4 +1144,212 @@ TEST(BoardLocationTests, ThrowsOnInvalidRow)
 TEST(BoardLocationTests, ThrowsOnInvalidCol)
 {
     EXPECT_THROW(BoardLocation("i1"), std::runtime_error);
-}
\ No newline at end of file
+}
+
+// --- FEN parsing ---
+
+TEST(FenTests, ReadsStartPosition)
+{
+    auto board = board_from_fen<BitBoard>(START_FEN);
+
+    EXPECT_EQ(board.get_occupied(), 0xffff0000'0000ffffULL);
+    EXPECT_EQ(board.get_kings(), 0x10000000'00000010ULL);
+    EXPECT_EQ(board.get_colour_to_move(), PieceColour::WHITE);
+    EXPECT_TRUE(board.has_castling_rights(BitBoard::CastlingRights::WHITE_KINGSIDE));
+    EXPECT_TRUE(board.has_castling_rights(BitBoard::CastlingRights::BLACK_QUEENSIDE));
+    EXPECT_FALSE(board.get_enpassant_column().has_value());
+}
+
+TEST(FenTests, ReadsSideToMoveAndEnPassant)
+{
+    auto board = board_from_fen<BitBoard>("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b Kq e3 0 1");
+
+    EXPECT_EQ(board.get_colour_to_move(), PieceColour::BLACK);
+    ASSERT_TRUE(board.get_enpassant_column().has_value());
+    EXPECT_EQ(*board.get_enpassant_column(), 4);
+    EXPECT_TRUE(board.has_castling_rights(BitBoard::CastlingRights::WHITE_KINGSIDE));
+    EXPECT_FALSE(board.has_castling_rights(BitBoard::CastlingRights::WHITE_QUEENSIDE));
+    EXPECT_FALSE(board.has_castling_rights(BitBoard::CastlingRights::BLACK_KINGSIDE));
+    EXPECT_TRUE(board.has_castling_rights(BitBoard::CastlingRights::BLACK_QUEENSIDE));
+}
+
+TEST(FenTests, CountersAreOptional)
+{
+    auto board = board_from_fen<BitBoard>("4k3/8/8/8/8/8/8/4K3 w -");
+    EXPECT_EQ(board.get_kings(), 0x10000000'00000010ULL);
+}
+
+TEST(FenTests, ReadsHalfmoveClock)
+{
+    EXPECT_EQ(fen_halfmove_clock(START_FEN), 0);
+    EXPECT_EQ(fen_halfmove_clock("4k3/8/8/8/8/8/8/4K3 b - - 37 80"), 37);
+    EXPECT_EQ(fen_halfmove_clock("4k3/8/8/8/8/8/8/4K3 w -"), 0);
+    EXPECT_THROW(fen_halfmove_clock("4k3/8/8/8/8/8/8/4K3 w - - x 1"), std::runtime_error);
+    EXPECT_THROW(fen_halfmove_clock("4k3/8/8/8/8/8/8/4K3 w - - -3 1"), std::runtime_error);
+}
+
+TEST(FenTests, ThrowsOnMalformedFen)
+{
+    EXPECT_THROW(board_from_fen<BitBoard>(""), std::runtime_error);
+    EXPECT_THROW(board_from_fen<BitBoard>("4k3/8/8/8/8/8/8/4K3 x - - 0 1"), std::runtime_error);
+    EXPECT_THROW(board_from_fen<BitBoard>("4k3/8/8/8/8/8/4K3 w - - 0 1"), std::runtime_error);
+    EXPECT_THROW(board_from_fen<BitBoard>("4k4/8/8/8/8/8/8/4K3 w - - 0 1"), std::runtime_error);
+    EXPECT_THROW(board_from_fen<BitBoard>("4x3/8/8/8/8/8/8/4K3 w - - 0 1"), std::runtime_error);
+    EXPECT_THROW(board_from_fen<BitBoard>("4k3/8/8/8/8/8/8/4K3 w - z9 0 1"), std::runtime_error);
+}
+
+TEST(SeeTests, WinsUndefendedAndDefendedCaptures)
+{
+    // Pawn takes a knight defended by a pawn: +300 - 100
+    auto board = board_from_fen<BitBoard>("4k3/8/3p4/4n3/3P4/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(board.see(Move("d4e5")), 200);
+
+    // Rook takes an undefended pawn
+    board = board_from_fen<BitBoard>("7k/3p4/8/8/8/8/8/3RK3 w - - 0 1");
+    EXPECT_EQ(board.see(Move("d1d7")), 100);
+}
+
+TEST(SeeTests, LosesToCheaperRecapture)
+{
+    // Queen takes a pawn defended by a pawn
+    auto board = board_from_fen<BitBoard>("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+    EXPECT_EQ(board.see(Move("d1d5")), -800);
+    EXPECT_FALSE(board.see_ge(Move("d1d5"), 0));
+    EXPECT_TRUE(board.see_ge(Move("d1d5"), -800));
+}
+
+TEST(SeeTests, CountsXRayAttackers)
+{
+    // The second rook recaptures through the first, so black shouldn't take back.
+    auto board = board_from_fen<BitBoard>("3r2k1/8/8/3p4/8/8/3R4/3R2K1 w - - 0 1");
+    EXPECT_EQ(board.see(Move("d2d5")), 100);
+
+    // Without it, the exchange loses the rook.
+    board = board_from_fen<BitBoard>("3r2k1/8/8/3p4/8/8/3R4/6K1 w - - 0 1");
+    EXPECT_EQ(board.see(Move("d2d5")), -400);
+}
+
+TEST(SeeTests, HandlesEnPassantAndPromotion)
+{
+    auto board = board_from_fen<BitBoard>("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    EXPECT_EQ(board.see(Move("e5d6")), 100);
+
+    board = board_from_fen<BitBoard>("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(board.see(Move("a7a8q")), 800);
+}
+
+TEST(GivesCheckTests, DetectsDirectAndDiscoveredChecks)
+{
+    auto board = board_from_fen<BitBoard>("4k3/8/8/8/8/8/4N3/R3RK2 w - - 0 1");
+    EXPECT_TRUE(board.gives_check(Move("a1a8")));
+    EXPECT_FALSE(board.gives_check(Move("a1a7")));
+    EXPECT_TRUE(board.gives_check(Move("e2c3")));   // uncovers the rook on e1
+    EXPECT_FALSE(board.gives_check(Move("f1f2")));
+
+    board = board_from_fen<BitBoard>("4k3/8/5P2/8/2N5/8/8/4K3 w - - 0 1");
+    EXPECT_TRUE(board.gives_check(Move("c4d6")));
+    EXPECT_FALSE(board.gives_check(Move("c4b6")));
+    EXPECT_TRUE(board.gives_check(Move("f6f7")));
+
+    board = board_from_fen<BitBoard>("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_TRUE(board.gives_check(Move("a7a8q")));
+    EXPECT_FALSE(board.gives_check(Move("a7a8n")));
+}
+
+TEST(EvalTermsTests, IncrementalTotalsMatchRecomputeOverRandomGames)
+{
+    auto expect_match = [](const BitBoard& board) {
+        BitBoard recomputed(board);
+        recomputed.refresh_eval_terms();
+        EXPECT_EQ(board.get_psq_score(), recomputed.get_psq_score());
+        EXPECT_EQ(board.get_material_key(), recomputed.get_material_key());
+        EXPECT_EQ(board.get_pawn_key(), recomputed.get_pawn_key());
+    };
+
+    std::mt19937 rng(12345);
+    for (int game = 0; game < 20; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+        board.set_castling_rights({ BitBoard::CastlingRights::WHITE_KINGSIDE, BitBoard::CastlingRights::WHITE_QUEENSIDE,
+                                    BitBoard::CastlingRights::BLACK_KINGSIDE, BitBoard::CastlingRights::BLACK_QUEENSIDE });
+        const BitBoard start(board);
+
+        std::vector<Move> played;
+        for (int ply = 0; ply < 200; ++ply)
+        {
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+
+            Move move = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+            board.make_move(move);
+            played.push_back(move);
+            expect_match(board);
+        }
+
+        while (!played.empty())
+        {
+            board.unmake_move(played.back());
+            played.pop_back();
+            expect_match(board);
+        }
+        EXPECT_EQ(board.get_psq_score(), start.get_psq_score());
+        EXPECT_EQ(board.get_material_key(), start.get_material_key());
+        EXPECT_EQ(board.get_pawn_key(), start.get_pawn_key());
+    }
+}
+
+TEST(EvalTermsTests, PawnKeyDependsOnlyOnPawns)
+{
+    BitBoard board;
+    board.set_to_start_position();
+    const uint64_t start_key = board.get_pawn_key();
+
+    // Piece moves leave the pawn key alone.
+    board.make_move(Move("g1f3"));
+    board.make_move(Move("b8c6"));
+    EXPECT_EQ(board.get_pawn_key(), start_key);
+
+    // The same pawn moves in a different order give the same key.
+    BitBoard a(board), b(board);
+    a.make_move(Move("e2e4"));
+    a.make_move(Move("d7d5"));
+    b.make_move(Move("e2e4"));
+    b.make_move(Move("c6b8"));
+    b.make_move(Move("f3g1"));
+    b.make_move(Move("d7d5"));
+    EXPECT_NE(a.get_pawn_key(), start_key);
+    EXPECT_EQ(a.get_pawn_key(), b.get_pawn_key());
+
+    // Capturing a pawn changes it.
+    a.make_move(Move("e4d5"));
+    EXPECT_NE(a.get_pawn_key(), b.get_pawn_key());
+}
+
+TEST(EvalTermsTests, AttackMapsFromMoveGenerationMatchRecompute)
+{
+    std::mt19937 rng(4242);
+    for (int game = 0; game < 10; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+
+        for (int ply = 0; ply < 150; ++ply)
+        {
+            const bool white = board.get_colour_to_move() == PieceColour::WHITE;
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+
+            BitBoard recomputed(board);
+            recomputed.refresh_eval_terms();
+
+            // Pins restrict moves but not attacks, so both sides' maps are complete.
+            EXPECT_EQ(board.get_attack_maps(white), recomputed.get_attack_maps(white));
+            EXPECT_EQ(board.get_attack_maps(!white), recomputed.get_attack_maps(!white));
+
+            board.make_move(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)]);
+        }
+    }
+}
@@ -3,9 +3,13 @@
 #include "ai.h"
 
 #include <heuristic.h>
+#include <score.h>
 #include <bitboards/bitboard.h>
 #include <utils/board_strings.h>
 
+#include <limits>
+#include <random>
+
 using namespace utils;
 
 class HeuristicTests : public ::testing::Test
@@ -222,4 +226,229 @@ TEST_F(HeuristicTests, BlockedPawnsArePenalised)
     ShannonHeuristic unblocked(board_unblocked, PieceColour::WHITE);
 
     EXPECT_LT(blocked.get(), unblocked.get());
-}
\ No newline at end of file
+}
+
+TEST_F(HeuristicTests, PackedScoresKeepBothPhases)
+{
+    constexpr Score a = S(-30, 45);
+    constexpr Score b = S(12, -70);
+    static_assert(mg_value(a) == -30 && eg_value(a) == 45);
+
+    EXPECT_EQ(mg_value(a + b), -18);
+    EXPECT_EQ(eg_value(a + b), -25);
+    EXPECT_EQ(mg_value(a - b), -42);
+    EXPECT_EQ(eg_value(a - b), 115);
+    EXPECT_EQ(mg_value(-3 * a), 90);
+    EXPECT_EQ(eg_value(-3 * a), -135);
+
+    // Full phase is all middlegame, zero all endgame.
+    EXPECT_EQ(taper(a, 62, 62), -30);
+    EXPECT_EQ(taper(a, 0, 62), 45);
+    EXPECT_EQ(taper(S(0, 62), 31, 62), 31);
+}
+
+TEST_F(HeuristicTests, EvalTablesGiveSameScores)
+{
+    EvalTables tables;
+
+    std::mt19937 rng(4321);
+    for (int game = 0; game < 10; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+
+        for (int ply = 0; ply < 150; ++ply)
+        {
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+            board.make_move(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)]);
+
+            EXPECT_EQ(ShannonHeuristic(board, PieceColour::WHITE, &tables).get(),
+                      ShannonHeuristic(board, PieceColour::WHITE).get());
+        }
+    }
+
+    // Most moves in a game don't change the pawns or the material.
+    EXPECT_GT(tables.pawns.stats().hits, tables.pawns.stats().probes / 2);
+    EXPECT_GT(tables.material.stats().hits, tables.material.stats().probes / 2);
+}
+
+TEST_F(HeuristicTests, InsufficientMaterialIsDrawn)
+{
+    auto eval = [](const char* pieces) {
+        BitBoard board = board_from_string_repr<BitBoard>(std::string(pieces) + "w - - 0 1\n");
+        return ShannonHeuristic(board, PieceColour::WHITE).get();
+    };
+
+    // King and bishop
+    EXPECT_EQ(eval(" _ _ _ _ k _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ B _ K _ _ _\n"), 0.f);
+
+    // Two knights against a knight
+    EXPECT_EQ(eval(" _ _ _ _ k _ n _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ N _ _ K _ N _\n"), 0.f);
+
+    // Bishop and knight can mate.
+    EXPECT_GT(eval(" _ _ _ _ k _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ B _ K _ N _\n"), 5.f);
+
+    // So can a lone pawn, by promoting.
+    EXPECT_GT(eval(" _ _ _ _ k _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ _ _ _ _ _\n"
+                   " _ _ _ P _ _ _ _\n"
+                   " _ _ _ _ K _ _ _\n"), 0.5f);
+}
+
+TEST_F(HeuristicTests, LazyEvaluationStopsFarOutsideWindow)
+{
+    // White is a queen up.
+    auto board = board_from_string_repr<BitBoard>(
+        " _ _ _ _ k _ _ _\n"
+        " p p p _ _ p p p\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " P P P _ _ P P P\n"
+        " _ _ _ Q K _ _ _\n"
+        "w - - 0 1\n");
+
+    const float full = ShannonHeuristic(board, PieceColour::WHITE).get();
+
+    // Far above beta: a lower bound that still fails high
+    ShannonHeuristic above(board, PieceColour::WHITE, -0.5f, 0.5f);
+    EXPECT_TRUE(above.is_lazy());
+    EXPECT_GE(above.get(), 0.5f);
+    EXPECT_LE(above.get(), full);
+
+    // Far below alpha from Black's side: an upper bound that still fails low
+    ShannonHeuristic below(board, PieceColour::BLACK, -0.5f, 0.5f);
+    EXPECT_TRUE(below.is_lazy());
+    EXPECT_LE(below.get(), -0.5f);
+    EXPECT_GE(below.get(), -full);
+
+    // Near the window, every term counts.
+    ShannonHeuristic near(board, PieceColour::WHITE, full - 0.5f, full + 0.5f);
+    EXPECT_FALSE(near.is_lazy());
+    EXPECT_EQ(near.get(), full);
+}
+
+TEST_F(HeuristicTests, LazyEvaluationIsABoundInRandomGames)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+
+    // Random games reach lopsided pawn structures and piece placements that real ones rarely do,
+    // which is where a margin too small for the skipped terms would show.
+    std::mt19937 rng(2024);
+    int checked = 0;
+    for (int game = 0; game < 200; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+
+        for (int ply = 0; ply < 200; ++ply)
+        {
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+
+            for (PieceColour colour : { PieceColour::WHITE, PieceColour::BLACK })
+            {
+                // A window that can't be reached makes every evaluation lazy, unless it is a draw.
+                ShannonHeuristic upper(board, colour, inf, inf);
+                ShannonHeuristic lower(board, colour, -inf, -inf);
+                if (!upper.is_lazy())
+                    continue;
+
+                const float full = ShannonHeuristic(board, colour).get();
+                ASSERT_LE(full, upper.get()) << board_to_string_repr(board);
+                ASSERT_GE(full, lower.get()) << board_to_string_repr(board);
+                ++checked;
+            }
+
+            board.make_move(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)]);
+        }
+    }
+    EXPECT_GT(checked, 10000);
+}
+
+TEST_F(HeuristicTests, MobilityIsRewarded)
+{
+    // The rook is worth the same on a1 and e1, but on a1 its own knight and pawn shut it in.
+    auto eval = [](const char* rank_1) {
+        BitBoard board = board_from_string_repr<BitBoard>(
+            " _ _ _ _ _ _ _ k\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ K\n"
+            " _ _ _ _ P _ _ _\n"
+            " P _ _ _ _ _ _ _\n"
+            + std::string(rank_1) + "w - - 0 1\n");
+        return ShannonHeuristic(board, PieceColour::WHITE).get();
+    };
+
+    EXPECT_GT(eval(" _ N _ _ R _ _ _\n"), eval(" R N _ _ _ _ _ _\n"));
+}
+
+TEST_F(HeuristicTests, AttacksNearTheKingArePenalised)
+{
+    // The king is as safe on b1 as on g1 by the tables, but on g1 the queen and rook bear down on it.
+    auto eval = [](const char* rank_1) {
+        BitBoard board = board_from_string_repr<BitBoard>(
+            " k _ _ _ _ _ _ r\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ q _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            + std::string(rank_1) + "w - - 0 1\n");
+        return ShannonHeuristic(board, PieceColour::WHITE).get();
+    };
+
+    EXPECT_LT(eval(" _ _ _ _ _ _ K _\n"), eval(" _ K _ _ _ _ _ _\n"));
+}
+
+TEST_F(HeuristicTests, MoveGenerationAttackMapsGiveSameScores)
+{
+    for (const char* fen : { "r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+                             "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                             "8/5pk1/6p1/3R4/8/5PP1/r5K1/8 w - - 0 40",
+                             // Pinned pieces of the side to move
+                             "r3k2r/ppp2ppp/2n5/1B1pp3/1b1PP3/2N5/PPP2PPP/R3K2R w KQkq - 0 1",
+                             "r3k2r/ppp2ppp/2n5/1B1pp3/1b1PP3/2N5/PPP2PPP/R3K2R b KQkq - 0 1",
+                             "4k3/4r3/8/8/8/8/4R3/4K3 w - - 0 1",
+                             "4k3/4r3/8/8/8/8/4R3/4K3 b - - 0 1",
+                             "4k3/4q3/8/8/1b6/8/3N4/4K3 w - - 0 1" })
+    {
+        BitBoard board = board_from_fen<BitBoard>(fen);
+        const float from_scratch = ShannonHeuristic(board, board.get_colour_to_move()).get();
+
+        board.get_all_legal_moves(board.get_colour_to_move());
+        EXPECT_EQ(ShannonHeuristic(board, board.get_colour_to_move()).get(), from_scratch) << fen;
+    }
+}
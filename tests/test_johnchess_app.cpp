@@ -0,0 +1,343 @@
+#include "gtest/gtest.h"
+
+#include <johnchess_app.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A whole engine talking over streams, with the test playing the GUI. Input is handed over a line
+// at a time and reads block in between, as on a pipe, so the engine sees commands when it would in
+// a real game rather than all at once.
+class AppSession
+{
+private:
+    class Input : public std::streambuf
+    {
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::string m_pending;
+        std::string m_current;
+        bool m_closed = false;
+
+    protected:
+        int_type underflow() override
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [&] { return !m_pending.empty() || m_closed; });
+            if (m_pending.empty())
+                return traits_type::eof();
+
+            m_current = std::exchange(m_pending, std::string());
+            setg(m_current.data(), m_current.data(), m_current.data() + m_current.size());
+            return traits_type::to_int_type(*gptr());
+        }
+
+    public:
+        void send(const std::string& line)
+        {
+            std::lock_guard lock(m_mutex);
+            m_pending += line + "\n";
+            m_cv.notify_all();
+        }
+
+        void close()
+        {
+            std::lock_guard lock(m_mutex);
+            m_closed = true;
+            m_cv.notify_all();
+        }
+    };
+
+    class Output : public std::streambuf
+    {
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::string m_text;
+        size_t m_read = 0;
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                char ch = traits_type::to_char_type(c);
+                xsputn(&ch, 1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            std::lock_guard lock(m_mutex);
+            m_text.append(s, static_cast<size_t>(count));
+            m_cv.notify_all();
+            return count;
+        }
+
+    public:
+        // Wait for a line starting with prefix, after any line returned before
+        std::optional<std::string> wait_for_line(const std::string& prefix, std::chrono::seconds timeout)
+        {
+            std::unique_lock lock(m_mutex);
+            std::optional<std::string> found;
+            m_cv.wait_for(lock, timeout, [&] {
+                size_t end;
+                while ((end = m_text.find('\n', m_read)) != std::string::npos)
+                {
+                    std::string line = m_text.substr(m_read, end - m_read);
+                    m_read = end + 1;
+                    if (line.starts_with(prefix))
+                    {
+                        found = line;
+                        return true;
+                    }
+                }
+                return false;
+            });
+            return found;
+        }
+    };
+
+    Input m_input_buf;
+    Output m_output_buf;
+    std::istream m_in{ &m_input_buf };
+    std::ostream m_out{ &m_output_buf };
+    std::thread m_thread;
+
+public:
+    AppSession()
+    {
+        m_thread = std::thread([this] {
+            const char* argv[] = { "johnchess", "--threads", "1" };
+            JohnchessApp app(3, argv, m_in, m_out);
+            app.main_loop();
+        });
+    }
+
+    // End of input reads as 'quit'
+    ~AppSession()
+    {
+        m_input_buf.close();
+        m_thread.join();
+    }
+
+    void send(const std::string& line) { m_input_buf.send(line); }
+
+    std::optional<std::string> wait_for_line(const std::string& prefix,
+                                             std::chrono::seconds timeout = std::chrono::seconds(30))
+    {
+        return m_output_buf.wait_for_line(prefix, timeout);
+    }
+};
+
+TEST(JohnchessAppTests, RejectsBadArguments)
+{
+    auto message = [](std::vector<const char*> args) -> std::string {
+        args.insert(args.begin(), "johnchess");
+        try
+        {
+            JohnchessApp app(static_cast<int>(args.size()), args.data());
+        }
+        catch (const JohnchessApp::ArgumentError& e)
+        {
+            return e.what();
+        }
+        return "";
+    };
+
+    EXPECT_EQ(message({ "--threads" }), "--threads needs a value");
+    EXPECT_EQ(message({ "--threads", "0" }), "--threads must be at least 1");
+    EXPECT_EQ(message({ "--smp-mode", "ybwc" }), "--smp-mode must be lazy or abdada");
+    EXPECT_EQ(message({ "--epd-errors", "ignore" }), "--epd-errors must be fail or skip");
+    EXPECT_EQ(message({ "--frobnicate" }), "Unknown argument: --frobnicate");
+    EXPECT_EQ(message({ "--threads", "1", "--depth", "3" }), "");
+}
+
+TEST(JohnchessAppTests, UciGoWithoutLegalMovesSendsNullMove)
+{
+    AppSession session;
+    session.send("uci");
+    ASSERT_TRUE(session.wait_for_line("uciok"));
+
+    // Fool's mate: White is checkmated.
+    session.send("position fen rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+    session.send("go depth 1");
+    EXPECT_EQ(session.wait_for_line("bestmove"), "bestmove 0000");
+
+    // Stalemate
+    session.send("position fen 7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    session.send("go depth 1");
+    EXPECT_EQ(session.wait_for_line("bestmove"), "bestmove 0000");
+
+    session.send("position startpos");
+    session.send("go depth 1");
+    auto reply = session.wait_for_line("bestmove");
+    ASSERT_TRUE(reply);
+    EXPECT_NE(*reply, "bestmove 0000");
+}
+
+TEST(JohnchessAppTests, SettingsWhileThinkingDoNotAbandonTheMove)
+{
+    AppSession session;
+    session.send("xboard");
+    session.send("protover 2");
+    ASSERT_TRUE(session.wait_for_line("feature"));
+    session.send("new");
+    session.send("st 1");
+    session.send("go");
+    session.send("post");
+    session.send("easy");
+    session.send("level 40 5 0");
+    session.send("ping 1");
+    EXPECT_TRUE(session.wait_for_line("pong 1"));
+    EXPECT_TRUE(session.wait_for_line("move ", std::chrono::seconds(10)));
+}
+
+TEST(JohnchessAppTests, UciCommandsAfterStopAreNotLost)
+{
+    AppSession session;
+    session.send("uci");
+    ASSERT_TRUE(session.wait_for_line("uciok"));
+
+    session.send("position startpos");
+    session.send("go infinite");
+    session.send("stop");
+    session.send("position startpos moves e2e4");
+    session.send("go depth 2");
+
+    auto first = session.wait_for_line("bestmove");
+    ASSERT_TRUE(first);
+    auto second = session.wait_for_line("bestmove", std::chrono::seconds(10));
+    ASSERT_TRUE(second);
+    // The second search is for Black, after 1. e4
+    std::string move = second->substr(std::string("bestmove ").size(), 4);
+    EXPECT_TRUE(move[1] == '7' || move[1] == '8') << *second;
+}
+
+TEST(JohnchessAppTests, EditStartsNewMoveHistory)
+{
+    AppSession session;
+    session.send("xboard");
+    session.send("protover 2");
+    ASSERT_TRUE(session.wait_for_line("feature"));
+    session.send("new");
+    session.send("force");
+    session.send("e2e4");
+
+    session.send("edit");
+    session.send(".");
+
+    // Nothing before the edit can be taken back, so Black is still to move.
+    session.send("undo");
+    session.send("st 1");
+    session.send("go");
+    auto reply = session.wait_for_line("move ");
+    ASSERT_TRUE(reply);
+    char rank = reply->at(std::string("move ").size() + 1);
+    EXPECT_TRUE(rank == '7' || rank == '8') << *reply;
+}
+
+// --- xboard analyze mode ---
+
+// First move of the principal variation in a thinking line: depth score time nodes pv...
+static std::string first_pv_move(const std::string& thinking_line)
+{
+    std::istringstream fields(thinking_line);
+    std::string field;
+    for (int i = 0; i < 5; ++i)
+        fields >> field;
+    return field;
+}
+
+static void start_analyzing(AppSession& session)
+{
+    session.send("xboard");
+    session.send("protover 2");
+    ASSERT_TRUE(session.wait_for_line("feature"));
+    session.send("new");
+    session.send("force");
+    session.send("analyze");
+}
+
+TEST(JohnchessAppTests, AnalyzeStreamsEachIteration)
+{
+    AppSession session;
+    start_analyzing(session);
+
+    for (std::string depth : { "1 ", "2 ", "3 " })
+    {
+        auto line = session.wait_for_line(depth);
+        ASSERT_TRUE(line) << "no thinking line for depth " << depth;
+        EXPECT_EQ(first_pv_move(*line).size(), 4u) << *line;
+    }
+}
+
+TEST(JohnchessAppTests, AnalyzeAnswersStatusRequest)
+{
+    AppSession session;
+    start_analyzing(session);
+    ASSERT_TRUE(session.wait_for_line("2 "));
+
+    session.send(".");
+    auto status = session.wait_for_line("stat01: ");
+    ASSERT_TRUE(status);
+
+    // stat01: time nodes depth moves-left total-moves
+    std::istringstream fields(status->substr(std::string("stat01: ").size()));
+    int elapsed_cs, depth, moves_left, total_moves;
+    uint64_t nodes;
+    ASSERT_TRUE(fields >> elapsed_cs >> nodes >> depth >> moves_left >> total_moves);
+    EXPECT_GE(depth, 2);
+    EXPECT_GT(nodes, 0u);
+    EXPECT_EQ(total_moves, 20);
+}
+
+TEST(JohnchessAppTests, AnalyzeRestartsAfterMoveAndUndo)
+{
+    AppSession session;
+    start_analyzing(session);
+    ASSERT_TRUE(session.wait_for_line("3 "));
+
+    // The new search starts again from depth 1, now with Black to move.
+    session.send("e2e4");
+    auto line = session.wait_for_line("1 ");
+    ASSERT_TRUE(line);
+    char rank = first_pv_move(*line)[1];
+    EXPECT_TRUE(rank == '7' || rank == '8') << *line;
+
+    session.send(".");
+    auto status = session.wait_for_line("stat01: ");
+    ASSERT_TRUE(status);
+    EXPECT_TRUE(status->ends_with(" 20 20")) << *status;
+
+    session.send("undo");
+    line = session.wait_for_line("1 ");
+    ASSERT_TRUE(line);
+    rank = first_pv_move(*line)[1];
+    EXPECT_TRUE(rank == '1' || rank == '2') << *line;
+}
+
+TEST(JohnchessAppTests, ExitStopsAnalysis)
+{
+    AppSession session;
+    start_analyzing(session);
+    ASSERT_TRUE(session.wait_for_line("2 "));
+
+    session.send("exit");
+    session.send("ping 1");
+    ASSERT_TRUE(session.wait_for_line("pong 1"));
+
+    // Nothing more once analysis has stopped, and no status either.
+    session.send(".");
+    EXPECT_FALSE(session.wait_for_line("", std::chrono::seconds(1)));
+}
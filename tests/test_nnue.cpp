@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+
+#include <nnue.h>
+#include <search_thread_pool.h>
+#include <bitboards/bitboard.h>
+#include <utils/board_strings.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace utils;
+
+// Made by data/make_tiny_nnue.py
+static std::shared_ptr<const nnue::Network> tiny_network()
+{
+    static auto network = nnue::load_network(std::string(TEST_DATA_DIR) + "/tiny.nnue");
+    return network;
+}
+
+TEST(NnueTests, LoadsTestNetwork)
+{
+    EXPECT_EQ(tiny_network()->hidden_size(), 32);
+}
+
+TEST(NnueTests, RejectsMalformedNetworks)
+{
+    auto load = [](const std::string& data) {
+        std::istringstream in(data);
+        nnue::Network network(in);
+    };
+
+    EXPECT_THROW(load("XXXX"), std::runtime_error);
+    EXPECT_THROW(load(std::string("JCNN\x02\0\0\0\x20\0\0\0", 12)), std::runtime_error);  // version 2
+    EXPECT_THROW(load(std::string("JCNN\x01\0\0\0\x21\0\0\0", 12)), std::runtime_error);  // 33 hidden
+    EXPECT_THROW(load(std::string("JCNN\x01\0\0\0\x20\0\0\0", 12) + "short"), std::runtime_error);
+    EXPECT_THROW(nnue::load_network("no/such/file.nnue"), std::runtime_error);
+}
+
+TEST(NnueTests, EvaluationMatchesScalarReference)
+{
+    auto network = tiny_network();
+    BitBoard board = board_from_string_repr<BitBoard>(
+        " r _ _ _ k _ _ r\n"
+        " p _ p p q p b _\n"
+        " b n _ _ p n p _\n"
+        " _ _ _ P N _ _ _\n"
+        " _ p _ _ P _ _ _\n"
+        " _ _ N _ _ Q _ p\n"
+        " P P P B B P P P\n"
+        " R _ _ _ K _ _ R\n"
+        "w KQkq - 1 8\n");
+    board.set_network(network);
+
+    // Straightforward sums, whichever kernels the library was built with
+    const int n = network->hidden_size();
+    std::vector<int32_t> acc[2];
+    for (bool white : { true, false })
+    {
+        acc[!white].assign(network->input_biases(), network->input_biases() + n);
+        for (int sq = 0; sq < 64; ++sq)
+        {
+            uint64_t bit = 1ULL << sq;
+            if (!(board.get_occupied() & bit))
+                continue;
+
+            bool piece_white = (board.pieces_to_move(true) & bit) != 0;
+            PieceType type = (board.get_pawns() & bit) ? PieceType::PAWN :
+                             (board.get_knights() & bit) ? PieceType::KNIGHT :
+                             (board.get_bishops() & bit) ? PieceType::BISHOP :
+                             (board.get_rooks() & bit) ? PieceType::ROOK :
+                             (board.get_queens() & bit) ? PieceType::QUEEN : PieceType::KING;
+            const int16_t* w = network->input_weights(nnue::feature(type, piece_white, sq, white));
+            for (int i = 0; i < n; ++i)
+                acc[!white][i] += w[i];
+        }
+        EXPECT_TRUE(std::equal(acc[!white].begin(), acc[!white].end(), board.get_accumulator()->side(white)));
+    }
+
+    int64_t output = network->output_bias();
+    for (int i = 0; i < n; ++i)
+    {
+        output += std::clamp(acc[0][i], 0, nnue::QA) * network->output_weights()[i];
+        output += std::clamp(acc[1][i], 0, nnue::QA) * network->output_weights()[n + i];
+    }
+    EXPECT_EQ(board.get_accumulator()->evaluate(true), output * nnue::OUTPUT_SCALE / (nnue::QA * nnue::QB));
+}
+
+TEST(NnueTests, IncrementalAccumulatorMatchesRefreshOverRandomGames)
+{
+    auto network = tiny_network();
+    const int n = network->hidden_size();
+
+    auto expect_match = [&](const BitBoard& board) {
+        BitBoard refreshed(board);
+        refreshed.set_network(network);
+        for (bool white : { true, false })
+        {
+            const int16_t* a = board.get_accumulator()->side(white);
+            EXPECT_TRUE(std::equal(a, a + n, refreshed.get_accumulator()->side(white)));
+        }
+    };
+
+    std::mt19937 rng(777);
+    for (int game = 0; game < 10; ++game)
+    {
+        BitBoard board;
+        board.set_to_start_position();
+        board.set_castling_rights({ BitBoard::CastlingRights::WHITE_KINGSIDE, BitBoard::CastlingRights::WHITE_QUEENSIDE,
+                                    BitBoard::CastlingRights::BLACK_KINGSIDE, BitBoard::CastlingRights::BLACK_QUEENSIDE });
+        board.set_network(network);
+
+        std::vector<Move> played;
+        for (int ply = 0; ply < 150; ++ply)
+        {
+            auto moves = board.get_all_legal_moves(board.get_colour_to_move());
+            if (moves.empty())
+                break;
+            Move move = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+            board.make_move(move);
+            played.push_back(move);
+            expect_match(board);
+        }
+
+        while (!played.empty())
+        {
+            board.unmake_move(played.back());
+            played.pop_back();
+            expect_match(board);
+        }
+    }
+}
+
+TEST(NnueTests, MirroredPositionScoresTheSame)
+{
+    auto network = tiny_network();
+    BitBoard board = board_from_string_repr<BitBoard>(
+        " _ _ _ _ k _ _ r\n"
+        " p p _ _ _ p p _\n"
+        " _ _ n _ _ _ _ p\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ B P _ _ _ _\n"
+        " _ _ _ _ _ N _ _\n"
+        " P P _ _ _ P P P\n"
+        " R _ _ Q _ R K _\n"
+        "w - - 0 1\n");
+    BitBoard mirrored = board_from_string_repr<BitBoard>(
+        " r _ _ q _ r k _\n"
+        " p p _ _ _ p p p\n"
+        " _ _ _ _ _ n _ _\n"
+        " _ _ b p _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ N _ _ _ _ P\n"
+        " P P _ _ _ P P _\n"
+        " _ _ _ _ K _ _ R\n"
+        "b - - 0 1\n");
+    board.set_network(network);
+    mirrored.set_network(network);
+
+    EXPECT_EQ(board.get_accumulator()->evaluate(true), mirrored.get_accumulator()->evaluate(false));
+}
+
+TEST(NnueTests, TestNetworkPrefersMaterial)
+{
+    BitBoard board = board_from_string_repr<BitBoard>(
+        " _ _ _ _ k _ _ _\n"
+        " p p p _ _ p p p\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " P P P _ _ P P P\n"
+        " _ _ _ Q K _ _ _\n"
+        "w - - 0 1\n");
+    board.set_network(tiny_network());
+
+    EXPECT_GT(board.get_accumulator()->evaluate(true), 200);
+    EXPECT_LT(board.get_accumulator()->evaluate(false), -200);
+}
+
+TEST(NnueTests, SearchesWithNetwork)
+{
+    SearchThreadPool pool(1);
+    pool.set_network(tiny_network());
+
+    // Black's queen is hanging.
+    BitBoard board = board_from_string_repr<BitBoard>(
+        " _ _ _ _ k _ _ _\n"
+        " p p p _ _ p p p\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ q _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " _ _ _ _ _ _ _ _\n"
+        " P P P _ _ P P P\n"
+        " _ _ _ R K _ _ _\n"
+        "w - - 0 1\n");
+
+    SearchLimits limits;
+    limits.max_depth = 4;
+    pool.start_search(board, limits, PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result(), Move("d1d5"));
+}
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <position_history.h>
+
+#include <bitboards/bitboard.h>
+#include <utils/board_strings.h>
+#include <zobrist_hash.h>
+
+using namespace utils;
+
+TEST(PositionHistoryTests, DetectsRepetitionWithSameSideToMove)
+{
+    PositionHistory history;
+    history.reset(1);
+    history.push(2, false);
+    history.push(3, false);
+    history.push(4, false);
+    EXPECT_FALSE(history.is_repetition());
+
+    // Back to the first position, four plies later.
+    history.push(1, false);
+    EXPECT_TRUE(history.is_repetition());
+
+    history.pop();
+    EXPECT_EQ(history.key(), 4u);
+    EXPECT_FALSE(history.is_repetition());
+}
+
+TEST(PositionHistoryTests, IrreversibleMoveEndsTheSearch)
+{
+    PositionHistory history;
+    history.reset(1);
+    history.push(2, false);
+    history.push(3, true);     // e.g. a capture: nothing before it can repeat
+    history.push(4, false);
+    history.push(1, false);
+    EXPECT_EQ(history.halfmove_clock(), 2);
+    EXPECT_FALSE(history.is_repetition());
+}
+
+TEST(PositionHistoryTests, FiftyMoveRule)
+{
+    PositionHistory history;
+    history.reset(1, PositionHistory::FIFTY_MOVE_PLIES - 1);
+    EXPECT_FALSE(history.is_fifty_move_draw());
+
+    history.push(2, false);
+    EXPECT_TRUE(history.is_fifty_move_draw());
+
+    history.push(3, true);
+    EXPECT_FALSE(history.is_fifty_move_draw());
+}
+
+TEST(PositionHistoryTests, KnightShuffleRepeatsStartPosition)
+{
+    ZobristHash hasher;
+    BitBoard board = board_from_fen<BitBoard>(START_FEN);
+
+    PositionHistory history;
+    history.reset(hasher.get_hash(board));
+
+    for (const char* move_str : { "g1f3", "g8f6", "f3g1", "f6g8" })
+    {
+        Move move(move_str);
+        EXPECT_FALSE(PositionHistory::resets_clock(board, move));
+        board.make_move(move);
+        history.push(hasher.get_hash(board), false);
+    }
+
+    EXPECT_TRUE(history.is_repetition());
+    EXPECT_EQ(history.halfmove_clock(), 4);
+    EXPECT_TRUE(PositionHistory::resets_clock(board, Move("e2e4")));
+}
+
+TEST(PositionHistoryTests, HashersAgree)
+{
+    BitBoard board = board_from_fen<BitBoard>(START_FEN);
+    EXPECT_EQ(ZobristHash().get_hash(board), ZobristHash().get_hash(board));
+}
@@ -0,0 +1,481 @@
+#include "gtest/gtest.h"
+
+#include <search_thread_pool.h>
+
+#include <bitboards/bitboard.h>
+#include <utils/board_strings.h>
+#include <chrono>
+#include <map>
+#include <thread>
+
+using namespace utils;
+
+static auto limits() {
+    return SearchLimits::until(std::chrono::steady_clock::now() + std::chrono::seconds(30));
+}
+
+class SearchThreadPoolTests : public ::testing::Test
+{
+protected:
+    // Knight on g6 forks queen on c8 and king on g8 via Nge7+.
+    BitBoard fork_board()
+    {
+        std::string board_str(
+            " _ _ q _ _ _ k _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ N _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ _ _\n"
+            " _ _ _ _ _ _ K _\n"
+        );
+
+        auto board = board_from_string_repr<BitBoard>(board_str);
+        board.set_colour_to_move(PieceColour::WHITE);
+        return board;
+    }
+};
+
+TEST_F(SearchThreadPoolTests, MultipleThreadsFindFork)
+{
+    SearchThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+}
+
+TEST_F(SearchThreadPoolTests, PoolIsReusedAcrossSearches)
+{
+    SearchThreadPool pool(3);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+        EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+    }
+}
+
+TEST_F(SearchThreadPoolTests, ResizeBetweenSearches)
+{
+    SearchThreadPool pool(1);
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+
+    pool.resize(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+
+    pool.resize(0);
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST_F(SearchThreadPoolTests, StopEndsSearchEarly)
+{
+    SearchThreadPool pool(2);
+    BitBoard board;
+    board.set_to_start_position();
+
+    auto start = std::chrono::steady_clock::now();
+    pool.start_search(board, limits(), PieceColour::WHITE);
+    pool.stop();
+    auto move = pool.wait_for_result();
+
+    EXPECT_TRUE(move.is_valid());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SearchThreadPoolTests, IdlePoolCanBeResizedBeforeFirstSearch)
+{
+    SearchThreadPool pool(2);
+
+    pool.resize(3);
+    EXPECT_EQ(pool.size(), 3u);
+    pool.resize(3);
+    EXPECT_EQ(pool.size(), 3u);
+    pool.resize(1);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_FALSE(pool.is_searching());
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+}
+
+TEST_F(SearchThreadPoolTests, IsSearchingUntilAllThreadsFinish)
+{
+    SearchThreadPool pool(3);
+    BitBoard board;
+    board.set_to_start_position();
+
+    EXPECT_FALSE(pool.is_searching());
+    pool.start_search(board, limits(), PieceColour::WHITE);
+    EXPECT_TRUE(pool.is_searching());
+
+    pool.stop();
+    EXPECT_TRUE(pool.wait_for_result().is_valid());
+    EXPECT_FALSE(pool.is_searching());
+}
+
+TEST_F(SearchThreadPoolTests, StopWhileIdleDoesNotAffectNextSearch)
+{
+    SearchThreadPool pool(2);
+    pool.stop();
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+}
+
+TEST_F(SearchThreadPoolTests, DestroyingIdlePoolJoinsThreads)
+{
+    auto start = std::chrono::steady_clock::now();
+    {
+        SearchThreadPool pool(4);
+        pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+        pool.wait_for_result();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SearchThreadPoolTests, DestroyingPoolStopsRunningSearch)
+{
+    BitBoard board;
+    board.set_to_start_position();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        SearchThreadPool pool(4);
+        pool.start_search(board, limits(), PieceColour::WHITE);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SearchThreadPoolTests, DepthLimitedSearchStopsAtMaxDepth)
+{
+    SearchThreadPool pool(2);
+    BitBoard board;
+    board.set_to_start_position();
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 3;
+
+    uint8_t last_depth = 0;
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t depth, int, int, uint64_t, const std::string&, uint8_t) { last_depth = depth; });
+    auto move = pool.wait_for_result();
+
+    EXPECT_TRUE(move.is_valid());
+    EXPECT_EQ(last_depth, 3);
+    EXPECT_GT(pool.nodes_searched(), 0u);
+}
+
+TEST_F(SearchThreadPoolTests, ThinkingReportsNodesOfAllThreads)
+{
+    SearchThreadPool pool(3);
+    BitBoard board;
+    board.set_to_start_position();
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 4;
+
+    // Holding up the main thread after the first depth lets the helpers get well ahead of it.
+    uint64_t total_after_pause = 0;
+    uint64_t reported_at_depth_2 = 0;
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t depth, int, int, uint64_t nodes, const std::string&, uint8_t) {
+                          if (depth == 1)
+                          {
+                              std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                              total_after_pause = pool.nodes_searched();
+                          }
+                          else if (depth == 2)
+                          {
+                              reported_at_depth_2 = nodes;
+                          }
+                      });
+    pool.wait_for_result();
+
+    EXPECT_GE(reported_at_depth_2, total_after_pause);
+    EXPECT_LE(reported_at_depth_2, pool.nodes_searched());
+}
+
+TEST_F(SearchThreadPoolTests, VoteKeepsMainMoveAgainstDeeperButWorseHelper)
+{
+    std::vector<SearchResult> results = {
+        { Move("e2e4"), 0.5f, 8 },
+        { Move("d2d4"), 0.2f, 12 },
+        { Move("d2d4"), 0.3f, 11 },
+    };
+    EXPECT_EQ(SearchThreadPool::vote_best_move(results), Move("e2e4"));
+}
+
+TEST_F(SearchThreadPoolTests, VoteMarginIsCapped)
+{
+    // A shallow helper's huge score doesn't outweigh deeper threads agreeing with the main thread.
+    std::vector<SearchResult> results = {
+        { Move("e2e4"), 0.5f, 12 },
+        { Move("e2e4"), 0.6f, 12 },
+        { Move("e2e4"), 0.6f, 12 },
+        { Move("d2d4"), 60.f, 4 },
+    };
+    EXPECT_EQ(SearchThreadPool::vote_best_move(results), Move("e2e4"));
+
+    // A better helper result of the same depth still wins over the main thread alone.
+    results = {
+        { Move("e2e4"), 0.5f, 10 },
+        { Move("d2d4"), 1.f, 10 },
+    };
+    EXPECT_EQ(SearchThreadPool::vote_best_move(results), Move("d2d4"));
+}
+
+TEST_F(SearchThreadPoolTests, VoteTakesShortestProvenMate)
+{
+    std::vector<SearchResult> results = {
+        { Move("e2e4"), 3.f, 12 },
+        { Move("d1h5"), MATE_SCORE - 5, 6 },
+        { Move("f1c4"), MATE_SCORE - 3, 4 },
+        { Move("e2e4"), 2.5f, 12 },
+    };
+    EXPECT_EQ(SearchThreadPool::vote_best_move(results), Move("f1c4"));
+}
+
+TEST_F(SearchThreadPoolTests, VoteIgnoresHelpersWithoutCompletedIteration)
+{
+    std::vector<SearchResult> results = {
+        { Move("e2e4"), 0.5f, 6 },
+        { Move("d2d4"), MATE_SCORE - 1, 0 },
+    };
+    EXPECT_EQ(SearchThreadPool::vote_best_move(results), Move("e2e4"));
+}
+
+TEST_F(SearchThreadPoolTests, AbdadaThreadsFindFork)
+{
+    SearchThreadPool pool(4);
+    pool.set_mode(ParallelMode::ABDADA);
+    EXPECT_EQ(pool.get_mode(), ParallelMode::ABDADA);
+
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+
+    // Threads added after the mode switch share work too.
+    pool.resize(6);
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+}
+
+TEST_F(SearchThreadPoolTests, AbdadaDepthLimitedSearchStopsAtMaxDepth)
+{
+    BitBoard board;
+    board.set_to_start_position();
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 4;
+
+    SearchThreadPool pool(3);
+    pool.set_mode(ParallelMode::ABDADA);
+
+    uint8_t last_depth = 0;
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t depth, int, int, uint64_t, const std::string&, uint8_t) { last_depth = depth; });
+    EXPECT_TRUE(pool.wait_for_result().is_valid());
+    EXPECT_EQ(last_depth, 4);
+}
+
+TEST_F(SearchThreadPoolTests, PonderSearchIgnoresLimitsUntilPonderHit)
+{
+    SearchThreadPool pool(2);
+
+    // Already expired, but must not end a pondering search.
+    SearchLimits ponder_limits = SearchLimits::until(std::chrono::steady_clock::now());
+
+    uint8_t last_depth = 0;
+    pool.start_search(fork_board(), ponder_limits, PieceColour::WHITE,
+                      [&](uint8_t depth, int, int, uint64_t, const std::string&, uint8_t) { last_depth = depth; }, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    auto start = std::chrono::steady_clock::now();
+    pool.ponder_hit(SearchLimits::until(start + std::chrono::milliseconds(200)));
+    auto move = pool.wait_for_result();
+
+    EXPECT_EQ(move.to_string(), "g6e7");
+    EXPECT_GT(last_depth, 1);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SearchThreadPoolTests, StopEndsPonderSearch)
+{
+    SearchThreadPool pool(2);
+    BitBoard board;
+    board.set_to_start_position();
+
+    auto start = std::chrono::steady_clock::now();
+    pool.start_search(board, SearchLimits(), PieceColour::WHITE, nullptr, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(pool.is_searching());
+    pool.stop();
+
+    EXPECT_TRUE(pool.wait_for_result().is_valid());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SearchThreadPoolTests, HashMoveGivesExpectedReply)
+{
+    SearchThreadPool pool(1);
+    BitBoard board = fork_board();
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 4;
+    pool.start_search(board, depth_limits, PieceColour::WHITE);
+    Move best = pool.wait_for_result();
+
+    board.make_move(best);
+    auto reply = pool.hash_move(board);
+    ASSERT_TRUE(reply.has_value());
+
+    // Black is in check from the knight, so the reply must be a king move.
+    EXPECT_EQ(reply->to_string().substr(0, 2), "g8");
+}
+
+TEST_F(SearchThreadPoolTests, MultiPvReportsDistinctLinesPerDepth)
+{
+    BitBoard board;
+    board.set_to_start_position();
+
+    SearchLimits multi_pv_limits;
+    multi_pv_limits.max_depth = 3;
+    multi_pv_limits.multi_pv = 3;
+
+    // First move and score of each line, by depth.
+    std::map<uint8_t, std::vector<std::pair<std::string, int>>> lines;
+    SearchThreadPool pool(2);
+    pool.start_search(board, multi_pv_limits, PieceColour::WHITE,
+                      [&](uint8_t depth, int score_cp, int, uint64_t, const std::string& pv, uint8_t pv_index) {
+                          EXPECT_EQ(pv_index, lines[depth].size() + 1);
+                          lines[depth].emplace_back(pv.substr(0, pv.find(' ')), score_cp);
+                      });
+    auto move = pool.wait_for_result();
+
+    ASSERT_EQ(lines.size(), 3u);
+    for (const auto& [depth, depth_lines] : lines)
+    {
+        ASSERT_EQ(depth_lines.size(), 3u);
+        EXPECT_NE(depth_lines[0].first, depth_lines[1].first);
+        EXPECT_NE(depth_lines[0].first, depth_lines[2].first);
+        EXPECT_NE(depth_lines[1].first, depth_lines[2].first);
+        EXPECT_GE(depth_lines[1].second, depth_lines[2].second);
+    }
+    EXPECT_TRUE(move.is_valid());
+}
+
+TEST_F(SearchThreadPoolTests, FiftyMoveRuleScoresDraw)
+{
+    // A queen up, but the next move without a capture or pawn move ends the game as a draw.
+    BitBoard board = board_from_fen<BitBoard>("k7/8/8/8/3Q4/8/8/7K w - - 99 80");
+
+    SearchThreadPool pool(1);
+    PositionHistory history;
+    history.reset(pool.get_hasher().get_hash(board), fen_halfmove_clock("k7/8/8/8/3Q4/8/8/7K w - - 99 80"));
+    pool.set_history(history);
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 3;
+
+    int last_score = -1;
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t, int score_cp, int, uint64_t, const std::string&, uint8_t) { last_score = score_cp; });
+    pool.wait_for_result();
+    EXPECT_EQ(last_score, 0);
+
+    // Without the game history the queen counts.
+    pool.set_history(PositionHistory());
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t, int score_cp, int, uint64_t, const std::string&, uint8_t) { last_score = score_cp; });
+    pool.wait_for_result();
+    EXPECT_GT(last_score, 500);
+}
+
+TEST_F(SearchThreadPoolTests, RepeatingAGamePositionScoresDraw)
+{
+    BitBoard board = board_from_fen<BitBoard>("k7/8/8/8/3Q4/8/8/7K w - - 0 1");
+    BitBoard repeated(board);
+    repeated.make_move(Move("d4d5"));
+
+    // The position after d4d5 occurred four plies before the root.
+    SearchThreadPool pool(1);
+    const ZobristHash& hasher = pool.get_hasher();
+    PositionHistory history;
+    history.reset(hasher.get_hash(repeated));
+    history.push(1, false);
+    history.push(2, false);
+    history.push(hasher.get_hash(board), false);
+    pool.set_history(history);
+
+    SearchLimits limits;
+    limits.max_depth = 2;
+    limits.multi_pv = 64;
+
+    std::map<std::string, int> scores;
+    pool.start_search(board, limits, PieceColour::WHITE,
+                      [&](uint8_t, int score_cp, int, uint64_t, const std::string& pv, uint8_t) {
+                          scores[pv.substr(0, pv.find(' '))] = score_cp;
+                      });
+    EXPECT_NE(pool.wait_for_result().to_string(), "d4d5");
+
+    ASSERT_EQ(scores.count("d4d5"), 1u);
+    EXPECT_EQ(scores["d4d5"], 0);
+    EXPECT_GT(scores["d4d6"], 500);
+}
+
+TEST_F(SearchThreadPoolTests, SelectivePruningCanBeSwitchedOff)
+{
+    BitBoard board = board_from_fen<BitBoard>(START_FEN);
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 5;
+
+    SearchThreadPool pool(1);
+    pool.start_search(board, depth_limits, PieceColour::WHITE);
+    EXPECT_TRUE(pool.wait_for_result().is_valid());
+    uint64_t pruned_nodes = pool.nodes_searched();
+
+    PruningParams no_pruning;
+    no_pruning.reverse_futility = false;
+    no_pruning.futility = false;
+    no_pruning.razoring = false;
+    no_pruning.late_move_pruning = false;
+    pool.set_pruning(no_pruning);
+    EXPECT_FALSE(pool.get_pruning().futility);
+
+    pool.clear_hash();
+    pool.start_search(board, depth_limits, PieceColour::WHITE);
+    EXPECT_TRUE(pool.wait_for_result().is_valid());
+    EXPECT_GT(pool.nodes_searched(), pruned_nodes);
+
+    // Still finds the fork with every technique enabled.
+    pool.set_pruning(PruningParams());
+    pool.start_search(fork_board(), limits(), PieceColour::WHITE);
+    EXPECT_EQ(pool.wait_for_result().to_string(), "g6e7");
+}
+
+TEST_F(SearchThreadPoolTests, QuiescenceSearchesCheckEvasions)
+{
+    // Rxe8+ Rxe8 Rxe8 mates. At depth 1 the last capture is only seen in quiescence, which must
+    // search the evasions rather than stand pat while in check.
+    BitBoard board = board_from_fen<BitBoard>("3rr1k1/5ppp/8/8/8/8/4RPPP/4R1K1 w - - 0 1");
+
+    SearchLimits depth_limits;
+    depth_limits.max_depth = 1;
+
+    std::optional<int> mate;
+    SearchThreadPool pool(1);
+    pool.start_search(board, depth_limits, PieceColour::WHITE,
+                      [&](uint8_t, int score_cp, int, uint64_t, const std::string&, uint8_t) {
+                          mate = mate_in_moves(score_cp);
+                      });
+
+    EXPECT_EQ(pool.wait_for_result().to_string(), "e2e8");
+    EXPECT_EQ(mate, 2);
+}
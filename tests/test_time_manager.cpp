@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include <time_manager.h>
+
+using namespace std::chrono;
+
+static int64_t soft_ms(const SearchLimits& limits)
+{
+    return duration_cast<milliseconds>(*limits.soft_deadline - limits.start).count();
+}
+
+static int64_t hard_ms(const SearchLimits& limits)
+{
+    return duration_cast<milliseconds>(limits.hard_deadline - limits.start).count();
+}
+
+class TimeManagerTests : public ::testing::Test
+{
+protected:
+    TimeManager tm;
+};
+
+TEST_F(TimeManagerTests, ParsesLevelWithMinutes)
+{
+    EXPECT_TRUE(tm.set_level("40", "5", "0"));
+    EXPECT_EQ(tm.get_time_remaining_ms(), 5 * 60 * 1000);
+}
+
+TEST_F(TimeManagerTests, ParsesLevelWithMinutesAndSeconds)
+{
+    EXPECT_TRUE(tm.set_level("0", "2:30", "1.5"));
+    EXPECT_EQ(tm.get_time_remaining_ms(), 150 * 1000);
+}
+
+TEST_F(TimeManagerTests, RejectsMalformedLevel)
+{
+    EXPECT_FALSE(tm.set_level("forty", "5", "0"));
+    EXPECT_FALSE(tm.set_level("40", "5:", "0"));
+    EXPECT_FALSE(tm.set_level("40", "5", "x"));
+}
+
+TEST_F(TimeManagerTests, FixedMoveTimeGivesEqualSoftAndHardLimits)
+{
+    tm.set_fixed_move_time(2000);
+    auto limits = tm.allocate(10);
+
+    ASSERT_TRUE(limits.soft_deadline.has_value());
+    EXPECT_EQ(soft_ms(limits), 2000 - TimeManager::MOVE_OVERHEAD_MS);
+    EXPECT_EQ(hard_ms(limits), 2000 - TimeManager::MOVE_OVERHEAD_MS);
+}
+
+TEST_F(TimeManagerTests, ConventionalControlSplitsTimeOverMovesToGo)
+{
+    tm.set_level(40, 40 * 1000, 0);
+    auto limits = tm.allocate(0);
+
+    // 40 moves to go with 40s left: about one second each.
+    EXPECT_NEAR(soft_ms(limits), 1000, 5);
+    EXPECT_GT(hard_ms(limits), soft_ms(limits));
+}
+
+TEST_F(TimeManagerTests, LastMoveBeforeControlMayUseMostOfTheClock)
+{
+    tm.set_level(40, 40 * 1000, 0);
+    tm.set_time_remaining(1000);   // 10s
+    auto limits = tm.allocate(39);
+
+    EXPECT_GT(soft_ms(limits), 5000);
+    EXPECT_LT(hard_ms(limits), 10000);
+}
+
+TEST_F(TimeManagerTests, IncrementIsAddedToTheAllocation)
+{
+    tm.set_level(0, 60 * 1000, 0);
+    auto without_inc = soft_ms(tm.allocate(0));
+
+    tm.set_level(0, 60 * 1000, 2000);
+    auto with_inc = soft_ms(tm.allocate(0));
+
+    EXPECT_GT(with_inc, without_inc + 1000);
+}
+
+TEST_F(TimeManagerTests, NeverAllocatesMoreThanTheClock)
+{
+    tm.set_level(0, 60 * 1000, 5000);
+    tm.set_time_remaining(50);   // 0.5s left but a large increment
+    auto limits = tm.allocate(20);
+
+    EXPECT_LE(hard_ms(limits), 500);
+    EXPECT_LE(soft_ms(limits), hard_ms(limits));
+}
+
+TEST_F(TimeManagerTests, SpendsLessWhenBehindOnTheClock)
+{
+    tm.set_level(0, 60 * 1000, 0);
+    tm.set_opponent_time(6000);
+    auto level = soft_ms(tm.allocate(0));
+
+    tm.set_opponent_time(12000);
+    auto behind = soft_ms(tm.allocate(0));
+
+    EXPECT_LT(behind, level);
+}
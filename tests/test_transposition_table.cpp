@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+
+#include <eval_cache.h>
+#include <transposition_table.h>
+
+TEST(TranspositionTableTests, SizeIsPowerOfTwoWithinLimit)
+{
+    TranspositionTable tt(1);
+    EXPECT_LE(tt.size() * sizeof(TTEntry), 1024u * 1024u);
+    EXPECT_GT(tt.size() * 2 * sizeof(TTEntry), 1024u * 1024u);
+    EXPECT_EQ(tt.size() & (tt.size() - 1), 0u);
+}
+
+TEST(TranspositionTableTests, EntryIsFoundByHash)
+{
+    TranspositionTable tt(1);
+    uint64_t hash = 0x123456789abcdefULL;
+
+    tt.entry(hash) = { hash, Move("e2e4"), 0.5f, 3, TTEntry::Flag::EXACT };
+
+    EXPECT_EQ(tt.entry(hash).key, hash);
+    EXPECT_EQ(tt.entry(hash + tt.size()).key, hash);  // same slot
+    EXPECT_EQ(tt.entry(hash + 1).flag, TTEntry::Flag::EMPTY);
+}
+
+TEST(TranspositionTableTests, HashfullAndClear)
+{
+    TranspositionTable tt(1);
+    EXPECT_EQ(tt.hashfull(), 0);
+
+    for (uint64_t i = 0; i < 500; ++i)
+        tt.entry(i) = { i, Move(), 0.f, 1, TTEntry::Flag::EXACT };
+    EXPECT_EQ(tt.hashfull(), 500);
+
+    tt.clear();
+    EXPECT_EQ(tt.hashfull(), 0);
+}
+
+TEST(TranspositionTableTests, ResizeDiscardsEntries)
+{
+    TranspositionTable tt(1);
+    tt.entry(7) = { 7, Move(), 0.f, 1, TTEntry::Flag::EXACT };
+
+    size_t small_size = tt.size();
+    tt.resize(2);
+    EXPECT_EQ(tt.size(), 2 * small_size);
+    EXPECT_EQ(tt.entry(7).flag, TTEntry::Flag::EMPTY);
+}
+
+TEST(EvalCacheTests, StoredScoreIsFoundAndCounted)
+{
+    EvalCache cache;
+    const uint64_t hash = 0x123456789abcdefULL;
+    float score = 0.f;
+
+    EXPECT_FALSE(cache.probe(hash, score));
+    cache.store(hash, -1.25f);
+    EXPECT_TRUE(cache.probe(hash, score));
+    EXPECT_EQ(score, -1.25f);
+
+    // Same slot, different position
+    EXPECT_FALSE(cache.probe(hash ^ (1ULL << 40), score));
+
+    EXPECT_EQ(cache.stats().probes, 3u);
+    EXPECT_EQ(cache.stats().hits, 1u);
+    cache.reset_stats();
+    EXPECT_EQ(cache.stats().probes, 0u);
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include <uci_interface.h>
+#include <sstream>
+
+class UciInterfaceTests : public ::testing::Test
+{
+protected:
+    std::stringstream in;
+    std::stringstream out;
+    std::unique_ptr<UciInterface> iface;
+
+    void SetUp() override
+    {
+        iface = std::make_unique<UciInterface>(std::make_shared<InputReader>(in), out, "TestEngine", "Tester");
+    }
+
+    UciInterface::CommandReceived send(const std::string& line)
+    {
+        in << line << "\n";
+        return iface->wait_for_command();
+    }
+};
+
+// --- Command parsing ---
+
+TEST_F(UciInterfaceTests, ParsesSimpleCommands)
+{
+    EXPECT_EQ(send("uci").get_type(), UciInterface::CommandReceived::UCI);
+    EXPECT_EQ(send("isready").get_type(), UciInterface::CommandReceived::ISREADY);
+    EXPECT_EQ(send("ucinewgame").get_type(), UciInterface::CommandReceived::UCINEWGAME);
+    EXPECT_EQ(send("stop").get_type(), UciInterface::CommandReceived::STOP);
+    EXPECT_EQ(send("ponderhit").get_type(), UciInterface::CommandReceived::PONDERHIT);
+    EXPECT_EQ(send("quit").get_type(), UciInterface::CommandReceived::QUIT);
+}
+
+TEST_F(UciInterfaceTests, UnknownCommandIsInvalid)
+{
+    EXPECT_TRUE(send("xboard").is_invalid());
+    EXPECT_TRUE(send("position").is_invalid());
+}
+
+TEST_F(UciInterfaceTests, ParsesPositionStartposWithMoves)
+{
+    auto cmd = send("position startpos moves e2e4 e7e5");
+    EXPECT_EQ(cmd.get_type(), UciInterface::CommandReceived::POSITION);
+    EXPECT_EQ(cmd.get_position_fen(), "startpos");
+    EXPECT_EQ(cmd.get_position_moves(), (std::vector<std::string>{ "e2e4", "e7e5" }));
+}
+
+TEST_F(UciInterfaceTests, ParsesPositionFen)
+{
+    auto cmd = send("position fen 8/8/8/8/8/8/8/K6k w - - 0 1 moves a1a2");
+    EXPECT_EQ(cmd.get_position_fen(), "8/8/8/8/8/8/8/K6k w - - 0 1");
+    EXPECT_EQ(cmd.get_position_moves(), (std::vector<std::string>{ "a1a2" }));
+
+    auto no_moves = send("position fen 8/8/8/8/8/8/8/K6k b - - 0 1");
+    EXPECT_EQ(no_moves.get_position_fen(), "8/8/8/8/8/8/8/K6k b - - 0 1");
+    EXPECT_TRUE(no_moves.get_position_moves().empty());
+}
+
+TEST_F(UciInterfaceTests, ParsesGoParams)
+{
+    auto cmd = send("go wtime 60000 btime 55000 winc 1000 binc 1000 movestogo 20");
+    EXPECT_EQ(cmd.get_type(), UciInterface::CommandReceived::GO);
+    EXPECT_EQ(cmd.get_go_param("wtime"), 60000);
+    EXPECT_EQ(cmd.get_go_param("btime"), 55000);
+    EXPECT_EQ(cmd.get_go_param("binc"), 1000);
+    EXPECT_EQ(cmd.get_go_param("movestogo"), 20);
+    EXPECT_FALSE(cmd.get_go_param("depth").has_value());
+    EXPECT_FALSE(cmd.has_go_flag("infinite"));
+}
+
+TEST_F(UciInterfaceTests, ParsesGoFlags)
+{
+    auto cmd = send("go ponder infinite");
+    EXPECT_TRUE(cmd.has_go_flag("ponder"));
+    EXPECT_TRUE(cmd.has_go_flag("infinite"));
+}
+
+TEST_F(UciInterfaceTests, ParsesSetOptionWithSpaces)
+{
+    auto cmd = send("setoption name Parallel search value Lazy SMP");
+    EXPECT_EQ(cmd.get_type(), UciInterface::CommandReceived::SETOPTION);
+    EXPECT_EQ(cmd.get_option_name(), "Parallel search");
+    EXPECT_EQ(cmd.get_option_value(), "Lazy SMP");
+
+    auto hash = send("setoption name Hash value 64");
+    EXPECT_EQ(hash.get_option_name(), "Hash");
+    EXPECT_EQ(hash.get_option_value(), "64");
+}
+
+// --- Output ---
+
+TEST_F(UciInterfaceTests, ReplyUciListsIdAndOptions)
+{
+    iface->add_option("Hash type spin default 32 min 1 max 4096");
+    iface->reply_uci();
+
+    EXPECT_EQ(out.str(),
+              "id name TestEngine\n"
+              "id author Tester\n"
+              "option name Hash type spin default 32 min 1 max 4096\n"
+              "uciok\n");
+}
+
+TEST_F(UciInterfaceTests, SendInfo)
+{
+    iface->send_info(5, 23, 2000, 100000, 150, "e2e4 e7e5");
+    EXPECT_EQ(out.str(), "info depth 5 score cp 23 time 2000 nodes 100000 nps 50000 hashfull 150 pv e2e4 e7e5\n");
+}
+
+TEST_F(UciInterfaceTests, SendBestMove)
+{
+    iface->send_bestmove("e2e4", std::string("e7e5"));
+    iface->send_bestmove("d2d4");
+    EXPECT_EQ(out.str(), "bestmove e2e4 ponder e7e5\nbestmove d2d4\n");
+}
+
+TEST_F(UciInterfaceTests, SendInfoMateScore)
+{
+    iface->send_info(4, 19700, 10, 1000, 0, "a2a7 h8g8 b1b8", std::nullopt, 2);
+    EXPECT_EQ(out.str(), "info depth 4 score mate 2 time 10 nodes 1000 nps 100000 hashfull 0 pv a2a7 h8g8 b1b8\n");
+}
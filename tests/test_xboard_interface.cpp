@@ -69,6 +69,42 @@ TEST_F(XBoardInterfaceTests, ParsesOtim)
     EXPECT_EQ(cmd.get_intparams().front(), 120);
 }
 
+TEST_F(XBoardInterfaceTests, ParsesSt)
+{
+    auto cmd = send("st 10");
+    EXPECT_EQ(cmd.get_type(), XBoardInterface::CommandReceived::ST);
+    EXPECT_EQ(cmd.get_intparams().front(), 10);
+}
+
+TEST_F(XBoardInterfaceTests, ParsesCores)
+{
+    auto cmd = send("cores 4");
+    EXPECT_EQ(cmd.get_type(), XBoardInterface::CommandReceived::CORES);
+    EXPECT_EQ(cmd.get_intparams().front(), 4);
+}
+
+TEST_F(XBoardInterfaceTests, ParsesHardAndEasy)
+{
+    EXPECT_EQ(send("hard").get_type(), XBoardInterface::CommandReceived::HARD);
+    EXPECT_EQ(send("easy").get_type(), XBoardInterface::CommandReceived::EASY);
+}
+
+TEST_F(XBoardInterfaceTests, ParsesAnalyzeCommands)
+{
+    EXPECT_EQ(send("analyze").get_type(), XBoardInterface::CommandReceived::ANALYZE);
+    EXPECT_EQ(send(".").get_type(), XBoardInterface::CommandReceived::STATUS);
+    EXPECT_EQ(send("exit").get_type(), XBoardInterface::CommandReceived::EXIT);
+}
+
+TEST_F(XBoardInterfaceTests, ParsesOption)
+{
+    auto cmd = send("option Parallel search=ABDADA");
+    EXPECT_EQ(cmd.get_type(), XBoardInterface::CommandReceived::OPTION);
+    ASSERT_EQ(cmd.get_params().size(), 2u);
+    EXPECT_EQ(cmd.get_params()[0], "Parallel");
+    EXPECT_EQ(cmd.get_params()[1], "search=ABDADA");
+}
+
 TEST_F(XBoardInterfaceTests, ParsesMemory)
 {
     auto cmd = send("memory 64");
@@ -149,6 +185,19 @@ TEST_F(XBoardInterfaceTests, SendThinkingFormat)
     EXPECT_EQ(out.str(), "5 42 100 99999 e2e4 e7e5\n");
 }
 
+TEST_F(XBoardInterfaceTests, SendThinkingMateScores)
+{
+    iface->send_thinking(3, 19700, 0, 3519, "a2a7 h8g8 b1b8", 2);
+    iface->send_thinking(6, -19500, 0, 45492, "h8g7", -3);
+    EXPECT_EQ(out.str(), "3 100002 0 3519 a2a7 h8g8 b1b8\n6 -100003 0 45492 h8g7\n");
+}
+
+TEST_F(XBoardInterfaceTests, SendAnalysisStatusFormat)
+{
+    iface->send_analysis_status(1234, 56789, 7, 3, 20);
+    EXPECT_EQ(out.str(), "stat01: 1234 56789 7 3 20\n");
+}
+
 TEST_F(XBoardInterfaceTests, SendMove)
 {
     iface->send_move("e2e4");